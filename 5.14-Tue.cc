@@ -93,3 +93,128 @@ cin.ignore();
 cin.ignore(5);
 cin.ignore(80, '\n');  //contain two, first is the length and second is the stop value
 //default values create more flexible functions
+
+
+// 5. Big Roster Files: Grading on Several Threads(report.cc)
+// The simple version:
+int main() {
+  ifstream f{"roster.txt"}; // each line: assns mt final
+  Student s;
+  while (f >> s.assns >> s.mt >> s.final) {
+    cout << s.grade() << endl; // endl flushes: one write to the OS per line!
+  }
+}
+// Two problems for a file with millions of lines:
+// -- endl asks for a flush after every line. Use '\n' and let the buffer 
+//    fill up; it is flushed when it's full and at the end of the program.
+// -- one thread does all the reading, parsing and grading.
+
+// Faster: cut the file into pieces (shards) by byte position, and let 
+//   several threads each read, parse and grade their own piece.
+// Output must still come out in the original order, so each shard 
+//   produces its own output string, and main writes them out in shard order.
+// A shard [begin, end) may start or stop in the middle of a line. Rule:
+//   a shard owns every line that STARTS inside it. So it skips the partial
+//   line at its beginning (the previous shard finishes that one) and reads
+//   past end to finish its last line.
+import <algorithm>;
+import <atomic>;
+import <charconv>;
+import <filesystem>;
+import <fstream>;
+import <future>;
+import <iostream>;
+import <string>;
+import <thread>;
+import <vector>;
+
+struct Shard {
+  std::string out;    // grades, one per line
+  size_t badLines = 0;
+};
+
+Shard gradeShard(const std::string& path, size_t begin, size_t end, size_t fileSize) {
+  Shard result;
+  // read [begin - 1, end) so we can see the line boundaries, 
+  //   then on until the last line that starts before end is complete
+  size_t from = begin == 0 ? 0 : begin - 1;
+  std::string buf(end - from, '\0');
+  std::ifstream f{path, std::ios::binary};
+  f.seekg(from);
+  f.read(buf.data(), buf.size());
+  size_t scan = buf.empty() ? 0 : buf.size() - 1; // a '\n' here or later ends it
+  while (buf.find('\n', scan) == std::string::npos && from + buf.size() < fileSize) {
+    scan = buf.size();
+    size_t more = std::min<size_t>(4096, fileSize - from - buf.size());
+    buf.resize(buf.size() + more);
+    f.read(buf.data() + scan, more);
+  }
+
+  const char* p = buf.data();
+  const char* last = buf.data() + buf.size();
+  const char* stop = buf.data() + (end - from); // lines must start before this
+  if (begin != 0) { // skip to the first line that starts at or after begin
+    p = std::find(p, last, '\n');
+    if (p != last) ++p;
+  }
+  char num[32];
+  while (p < stop && p < last) {
+    const char* eol = std::find(p, last, '\n');
+    int v[3];
+    bool ok = true;
+    const char* q = p;
+    for (int& x : v) {
+      while (q < eol && (*q == ' ' || *q == '\t' || *q == '\r')) ++q;
+      auto [next, ec] = std::from_chars(q, eol, x);
+      ok = ok && ec == std::errc{};
+      q = next;
+    }
+    if (ok) {
+      Student s{v[0], v[1], v[2]};
+      // same text as cout << s.grade(): general format, 6 significant digits
+      char* e = std::to_chars(num, num + sizeof num, s.grade(), std::chars_format::general, 6).ptr;
+      result.out.append(num, e);
+      result.out += '\n';
+    } else if (p != eol) { // ignore blank lines
+      ++result.badLines;
+    }
+    p = eol + 1;
+  }
+  return result;
+}
+
+int main(int argc, char* argv[]) {
+  std::string path = argc > 1 ? argv[1] : "roster.txt";
+  size_t fileSize = std::filesystem::file_size(path);
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  // more shards than threads, so a thread that finishes early takes another one
+  size_t numShards = std::max<size_t>(1, std::min<size_t>(threads * 8, fileSize / (1 << 20)));
+  size_t shardSize = fileSize / numShards + 1;
+
+  // a tiny thread pool: each worker keeps taking the next unclaimed shard
+  std::vector<std::promise<Shard>> done(numShards);
+  std::atomic<size_t> next = 0;
+  std::vector<std::thread> pool;
+  for (unsigned t = 0; t < threads; ++t) {
+    pool.emplace_back([&] {
+      for (size_t i; (i = next++) < numShards; ) {
+        size_t begin = i * shardSize, end = std::min(fileSize, begin + shardSize);
+        done[i].set_value(gradeShard(path, begin, end, fileSize));
+      }
+    });
+  }
+
+  // merge: write shard 0, then 1, ... as each becomes ready
+  // (shards are taken in order, so shard i is usually done before shard i + k)
+  std::ios::sync_with_stdio(false); // cout doesn't have to stay in step with C's stdout
+  size_t bad = 0;
+  for (auto& d : done) {
+    Shard s = d.get_future().get(); // waits until that shard is finished
+    std::cout.write(s.out.data(), s.out.size()); // one big buffered write
+    bad += s.badLines;
+  }
+  for (auto& t : pool) t.join();
+  if (bad) std::cerr << bad << " malformed lines skipped\n";
+}
+// Note: one get_future() per promise, and only call it once, 
+//   that is why we call it inside the loop and not store the futures.
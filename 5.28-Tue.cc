@@ -179,3 +179,117 @@ string s3 = s1 + s2; // build-in
 
 // Dependency Graph:
 // vector-impl.cc和main.cc都指向 vector.cc
+
+
+// ********** 5. Bulk Reading and Writing of Vecs **********
+// operator>> above does 5 formatted extractions per Vec (p1, x, c, y, p2), 
+//   and operator<< does 5 formatted insertions. Every one of them checks the
+//   stream state, the locale, skips whitespace, etc.
+// Fine for a few Vecs. Too slow for a file with millions of "(x, y)" lines.
+
+// Idea: read the whole file into memory once, then walk over the characters
+//   ourselves and let std::from_chars convert the numbers.
+// std::from_chars (in <charconv>):
+// -- no locale, no whitespace skipping, no exceptions, no allocation
+// -- returns {ptr, ec}: ptr = first char not consumed, ec = error code
+import <charconv>;
+import <string>;
+import <string_view>;
+import <vector>;
+
+struct VecParseError {
+  size_t line = 0, column = 0; // 1-based, where parsing failed
+  std::string what;            // empty means no error
+};
+
+// Parses every "(x, y)" record in text and appends it to out.
+// Whitespace (including newlines) is allowed between tokens.
+// Stops at the first bad record and says where it is.
+VecParseError parseVecs(std::string_view text, std::vector<Vec>& out) {
+  const char* p = text.data();
+  const char* end = p + text.size();
+  const char* lineStart = p;
+  size_t line = 1;
+
+  auto skipSpace = [&] {
+    while (p != end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+      if (*p == '\n') { ++line; lineStart = p + 1; }
+      ++p;
+    }
+  };
+  auto fail = [&](const char* msg) {
+    return VecParseError{line, static_cast<size_t>(p - lineStart) + 1, msg};
+  };
+  auto expect = [&](char ch) {
+    skipSpace();
+    if (p == end || *p != ch) return false;
+    ++p;
+    return true;
+  };
+  auto number = [&](int& n) {
+    skipSpace();
+    auto [next, ec] = std::from_chars(p, end, n);
+    if (ec != std::errc{}) return false;
+    p = next;
+    return true;
+  };
+
+  out.reserve(out.size() + text.size() / 8); // rough guess: "(1, 2)\n" is 7 chars
+  skipSpace();
+  while (p != end) {
+    Vec v;
+    if (!expect('(')) return fail("expected '('");
+    if (!number(v.x)) return fail("expected an integer");
+    if (!expect(',')) return fail("expected ','");
+    if (!number(v.y)) return fail("expected an integer");
+    if (!expect(')')) return fail("expected ')'");
+    out.push_back(v);
+    skipSpace();
+  }
+  return {};
+}
+
+// The writer goes the other way with std::to_chars.
+// Characters are collected in a buffer that the caller keeps and reuses, 
+//   so there is one allocation (at most) for the whole run 
+//   instead of per-Vec stream formatting.
+// An int has at most 11 chars, so "(x, y)\n" needs at most 2 * 11 + 5 = 27.
+void formatVecs(const std::vector<Vec>& vs, std::string& buf) {
+  buf.resize(vs.size() * 27); // worst case, shrunk at the end
+  char* p = buf.data();
+  for (const Vec& v : vs) {
+    *p++ = '(';
+    p = std::to_chars(p, p + 11, v.x).ptr;
+    *p++ = ',';
+    *p++ = ' ';
+    p = std::to_chars(p, p + 11, v.y).ptr;
+    *p++ = ')';
+    *p++ = '\n';
+  }
+  buf.resize(p - buf.data()); // keeps the capacity for the next call
+}
+
+// client
+import <fstream>;
+import <iostream>;
+import <sstream>;
+int main() {
+  std::ifstream in{"points.txt"};
+  std::stringstream ss;
+  ss << in.rdbuf();        // whole file in one read
+  std::string text = ss.str();
+
+  std::vector<Vec> vs;
+  VecParseError err = parseVecs(text, vs);
+  if (!err.what.empty()) {
+    std::cerr << "points.txt:" << err.line << ":" << err.column 
+              << ": " << err.what << std::endl;
+    return 1;
+  }
+
+  std::string buf; // reused for every batch we write
+  formatVecs(vs, buf);
+  std::cout.write(buf.data(), buf.size()); // one write instead of 5 per Vec
+}
+// Note: the same file still works with the old operator>>,
+//   the format "(x, y)" didn't change. Only how we read it.
@@ -1,6 +1,8 @@
 // dependency graph for 05-separate/example3
 // 指向vector.cc: vector-impl.cc, main.cc, linearAlg.cc
 // 指向linearAlg.cc: linearAlg.cc, main.cc
+// A full version with dense matrices (tiled multiply / transpose) is in
+//   5.30-linearAlg.cc, 5.30-linearAlg-impl.cc and 5.30-main.cc
 
 // A module itself can import the modules it needs for its own implementation
 
@@ -81,6 +83,66 @@ s.this->assns; // Not valid syntax. 'this' is only available inside the method b
 Student *p = &s; // &s == this inside the method body
 
 
+// ********** Many Students at Once: a Columnar Table **********
+// A roster is usually an array of Student structs:
+//   | assns mt final | assns mt final | assns mt final | ...
+// Computing everyone's grade calls grade() once per object.
+// If we instead store each field in its own array (columns):
+//   assns: | a0 a1 a2 ... |
+//   mt:    | m0 m1 m2 ... |
+//   final: | f0 f1 f2 ... |
+// then the grade computation is one simple loop over 3 arrays, and the 
+//   compiler can use SIMD instructions: several students per instruction.
+import <cstddef>;
+import <vector>;
+
+class StudentTable {
+  std::vector<int> assns, mt, final;
+
+public:
+  void add(const Student& s) {
+    assns.push_back(s.assns);
+    mt.push_back(s.mt);
+    final.push_back(s.final);
+  }
+  size_t size() const { return assns.size(); }
+  Student operator[](size_t i) const { return Student{assns[i], mt[i], final[i]}; }
+
+  // out[i] = grade of student i, for the whole table in one pass
+  void grades(std::vector<float>& out) const {
+    size_t n = size();
+    out.resize(n);
+    const int* a = assns.data();
+    const int* m = mt.data();
+    const int* f = final.data();
+    float* g = out.data();
+    for (size_t i = 0; i < n; ++i) {
+      // exactly the expression in Student::grade(): computed in double, 
+      //   same order of operations, then converted to float.
+      //   So every result is bit-for-bit the same as grade().
+      g[i] = a[i] * 0.4 + m[i] * 0.2 + f[i] * 0.4;
+    }
+  }
+};
+// compile with: g++20m -O3 -march=native -ffp-contract=off ...
+// -- -O3 -march=native: lets the compiler vectorize the loop
+// -- -ffp-contract=off: otherwise the compiler may fuse x * 0.4 + y into one
+//    "fused multiply-add" instruction (rounds once instead of twice), which
+//    can change the last bit. We promised the same results as grade().
+// We do NOT use -ffast-math for the same reason: it lets the compiler 
+//   reorder the additions.
+
+// client
+StudentTable roster;
+roster.add(Student{60, 70, 80});
+roster.add(Student{90, 85, 100});
+std::vector<float> g;
+roster.grades(g);
+for (size_t i = 0; i < roster.size(); ++i) {
+  std::cout << g[i] << " " << (g[i] == roster[i].grade()) << std::endl; // always 1
+}
+
+
 // ********** Initializing Objects **********
 Student s{60, 70, 80}; // assns = 60, mt = 70, final = 80
 			                 // uses the order of the fileds in Student
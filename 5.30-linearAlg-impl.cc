@@ -0,0 +1,106 @@
+// linearAlg implementation file (linearAlg-impl.cc)
+module linearAlg;
+import <algorithm>;
+import <stdexcept>;
+import <thread>;
+
+// Why tiles?
+// In the naive loop, for every c(i, j) we walk down a whole column of b.
+// Consecutive elements of a column are nc doubles apart in memory, 
+//   so each one is on a different cache line. Once b is bigger than the cache
+//   (L2 is typically ~1MB, L3 a few tens of MB), every access is a miss.
+// Instead we work on small square blocks (tiles) of a, b and c 
+//   that fit in the cache together, and finish all the work on them 
+//   before moving on. Each element is then loaded from memory a few times
+//   instead of n times.
+const size_t Tile = 64; // 3 tiles of 64 x 64 doubles = 96KB, fits in L2
+
+Matrix fromRows(const std::vector<Vec>& rows) {
+  Matrix m{rows.size(), 2};
+  for (size_t i = 0; i < rows.size(); ++i) {
+    m(i, 0) = rows[i].x;
+    m(i, 1) = rows[i].y;
+  }
+  return m;
+}
+
+Matrix multiplyNaive(const Matrix& a, const Matrix& b) {
+  if (a.cols() != b.rows()) throw std::invalid_argument{"multiplyNaive: size mismatch"};
+  Matrix c{a.rows(), b.cols()};
+  for (size_t i = 0; i < a.rows(); ++i) {
+    for (size_t j = 0; j < b.cols(); ++j) {
+      double sum = 0;
+      for (size_t k = 0; k < a.cols(); ++k) {
+        sum += a(i, k) * b(k, j); // b(k, j): walking down a column, stride nc
+      }
+      c(i, j) = sum;
+    }
+  }
+  return c;
+}
+
+// Computes rows [i0, i1) of c, one tile at a time.
+// Not exported: only used inside the module.
+static void multiplyRows(const Matrix& a, const Matrix& b, Matrix& c, size_t i0, size_t i1) {
+  size_t n = a.cols(), m = b.cols();
+  for (size_t kk = 0; kk < n; kk += Tile) {
+    size_t k1 = std::min(kk + Tile, n);
+    for (size_t jj = 0; jj < m; jj += Tile) {
+      size_t j1 = std::min(jj + Tile, m);
+      for (size_t i = i0; i < i1; ++i) {
+        double* ci = c.row(i);
+        const double* ai = a.row(i);
+        for (size_t k = kk; k < k1; ++k) {
+          double aik = ai[k];
+          const double* bk = b.row(k);
+          for (size_t j = jj; j < j1; ++j) { // i-k-j order: b and c walked along rows,
+            ci[j] += aik * bk[j];            // contiguous, so this loop vectorizes
+          }
+        }
+      }
+    }
+  }
+}
+
+Matrix multiply(const Matrix& a, const Matrix& b, unsigned threads) {
+  if (a.cols() != b.rows()) throw std::invalid_argument{"multiply: size mismatch"};
+  Matrix c{a.rows(), b.cols()};
+  size_t numBlocks = (a.rows() + Tile - 1) / Tile;
+  threads = std::max(1u, std::min<unsigned>(threads, numBlocks));
+  if (threads == 1) {
+    for (size_t ii = 0; ii < a.rows(); ii += Tile) {
+      multiplyRows(a, b, c, ii, std::min(ii + Tile, a.rows()));
+    }
+    return c;
+  }
+  // Each thread gets every threads-th block of rows of c.
+  // Different threads write to different rows, so no locking is needed.
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; ++t) {
+    workers.emplace_back([&a, &b, &c, t, threads] {
+      for (size_t ii = t * Tile; ii < a.rows(); ii += threads * Tile) {
+        multiplyRows(a, b, c, ii, std::min(ii + Tile, a.rows()));
+      }
+    });
+  }
+  for (auto& w : workers) w.join(); // wait for all of them before returning c
+  return c;
+}
+
+Matrix transpose(const Matrix& m) {
+  Matrix t{m.cols(), m.rows()};
+  // Naively, either the reads or the writes go down a column.
+  // Per tile, both the rows we read and the rows we write stay in cache.
+  for (size_t ii = 0; ii < m.rows(); ii += Tile) {
+    size_t i1 = std::min(ii + Tile, m.rows());
+    for (size_t jj = 0; jj < m.cols(); jj += Tile) {
+      size_t j1 = std::min(jj + Tile, m.cols());
+      for (size_t i = ii; i < i1; ++i) {
+        for (size_t j = jj; j < j1; ++j) {
+          t(j, i) = m(i, j);
+        }
+      }
+    }
+  }
+  return t;
+}
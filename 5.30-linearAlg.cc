@@ -0,0 +1,35 @@
+// linearAlg interface file (linearAlg.cc)
+// linearAlg imports vec (see the dependency graph in 5.30-Thu.cc)
+// Dense matrices, stored row-major in one contiguous vector<double>.
+export module linearAlg;
+import vec;
+import <cstddef>;
+import <vector>;
+
+export class Matrix {
+  size_t nr, nc;
+  std::vector<double> data; // element (i, j) is data[i * nc + j]
+
+public:
+  Matrix(size_t nr, size_t nc) : nr{nr}, nc{nc}, data(nr * nc, 0.0) { }
+  size_t rows() const { return nr; }
+  size_t cols() const { return nc; }
+  double& operator()(size_t i, size_t j) { return data[i * nc + j]; }
+  double operator()(size_t i, size_t j) const { return data[i * nc + j]; }
+  double* row(size_t i) { return data.data() + i * nc; }
+  const double* row(size_t i) const { return data.data() + i * nc; }
+};
+
+// An n x 2 matrix whose i-th row is rows[i]
+export Matrix fromRows(const std::vector<Vec>& rows);
+
+// The textbook triple loop, kept for comparison
+export Matrix multiplyNaive(const Matrix& a, const Matrix& b);
+
+// Cache-blocked (tiled) a * b.
+// threads > 1 splits the tiles across that many threads.
+// Throws std::invalid_argument if a.cols() != b.rows().
+export Matrix multiply(const Matrix& a, const Matrix& b, unsigned threads = 1);
+
+// Cache-blocked transpose
+export Matrix transpose(const Matrix& m);
@@ -0,0 +1,61 @@
+// client program (main.cc): benchmark of linearAlg
+// compile:
+// g++20m -O3 -march=native -c vector.cc linearAlg.cc
+// g++20m -O3 -march=native -c vector-impl.cc linearAlg-impl.cc main.cc
+// g++20m vector.o vector-impl.o linearAlg.o linearAlg-impl.o main.o -o main
+import vec;
+import linearAlg;
+import <algorithm>;
+import <chrono>;
+import <iostream>;
+import <thread>;
+import <vector>;
+
+double ms(auto start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+  unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  // 256:  3 * 512KB, about the size of L2
+  // 1024: 3 * 8MB,   bigger than L2, around L3
+  // 2048: 3 * 32MB,  bigger than L3 (the naive version takes a while here)
+  for (size_t n : {256, 1024, 2048}) {
+    Matrix a{n, n}, b{n, n};
+    for (size_t i = 0; i < n; ++i) {
+      for (size_t j = 0; j < n; ++j) {
+        a(i, j) = (i + j) % 7;
+        b(i, j) = (i * j) % 5;
+      }
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    Matrix c1 = multiplyNaive(a, b);
+    double naive = ms(t0);
+    t0 = std::chrono::steady_clock::now();
+    Matrix c2 = multiply(a, b);
+    double tiled = ms(t0);
+    t0 = std::chrono::steady_clock::now();
+    Matrix c3 = multiply(a, b, cores);
+    double par = ms(t0);
+    t0 = std::chrono::steady_clock::now();
+    Matrix at = transpose(a);
+    double tr = ms(t0);
+
+    std::cout << n << " x " << n << ": naive " << naive << "ms, tiled " << tiled 
+              << "ms, tiled on " << cores << " threads " << par << "ms, transpose " 
+              << tr << "ms" << std::endl;
+    // same answers (small integers, so the sums are exact)
+    if (c1(n - 1, n / 2) != c2(n - 1, n / 2) || c2(n - 1, n / 2) != c3(n - 1, n / 2)
+        || at(1, 0) != a(0, 1)) {
+      std::cout << "MISMATCH" << std::endl;
+    }
+  }
+
+  // Matrices of Vec rows: an n x 2 matrix times a 2 x 2 one maps every row.
+  std::vector<Vec> pts{Vec{1, 2}, Vec{3, 4}};
+  Matrix r{2, 2};
+  r(0, 1) = 1;
+  r(1, 0) = -1; // rotate by 90 degrees
+  Matrix rotated = multiply(fromRows(pts), r);
+  std::cout << rotated(0, 0) << ", " << rotated(0, 1) << std::endl; // -2, 1
+}
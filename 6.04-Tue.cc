@@ -82,3 +82,179 @@ struct Student {
 ... : x{rand()}, y{x}
 // y is initialized to the value of field x, which is a random number
 
+
+
+// ********** Using a Basis: Change of Coordinates **********
+// So far Basis just holds v1 and v2. What is it for?
+// Any point p can be written as p = a * v1 + b * v2.
+// (a, b) are the coordinates of p in the basis {v1, v2}.
+// -- fromBasis: (a, b) -> p        just a * v1 + b * v2
+// -- toBasis:   p -> (a, b)        need to solve for a and b, i.e. use the
+//                                  inverse of the 2x2 matrix [v1 v2]
+
+// Doing it one point at a time with Vec's operators:
+for (size_t i = 0; i < n; ++i) {
+  out[i] = b.getV1() * coords[i].x + b.getV2() * coords[i].y; // 2 temporary Vecs per point
+}
+// For millions of points we want:
+// -- the inverse computed once, in the ctor, not once per point
+// -- a plain loop over arrays of numbers, which the compiler can turn into
+//    SIMD instructions (several points per instruction)
+
+// Storing the x's together and the y's together ("struct of arrays") 
+//   instead of an array of Vec structs makes the loop easy to vectorize:
+import <cmath>;
+import <stdexcept>;
+import <vector>;
+struct VecArray {
+  std::vector<int> xs, ys; // point i is (xs[i], ys[i])
+  size_t size() const { return xs.size(); }
+};
+struct CoordArray {
+  std::vector<double> as, bs; // p_i = as[i] * v1 + bs[i] * v2
+  size_t size() const { return as.size(); }
+};
+
+class Basis {
+  Vec v1{1, 0}, v2{0, 1};
+  // inverse of [v1 v2], filled in by the ctor:
+  // a = i11 * x + i12 * y
+  // b = i21 * x + i22 * y
+  double i11, i12, i21, i22;
+
+public:
+  // v1 and v2 must be linearly independent (det != 0), otherwise
+  //   they are not a basis and there is no inverse.
+  // Throws std::invalid_argument if they are parallel (or one is zero).
+  Basis(const Vec& v1, const Vec& v2) : v1{v1}, v2{v2} {
+    double det = static_cast<double>(v1.x) * v2.y - static_cast<double>(v2.x) * v1.y;
+    if (det == 0) throw std::invalid_argument{"Basis: v1 and v2 are parallel"};
+    i11 =  v2.y / det;
+    i12 = -v2.x / det;
+    i21 = -v1.y / det;
+    i22 =  v1.x / det;
+  }
+
+  // points -> coordinates
+  void toBasis(const VecArray& in, CoordArray& out) const {
+    size_t n = in.size();
+    out.as.resize(n);
+    out.bs.resize(n);
+    const int* xs = in.xs.data();
+    const int* ys = in.ys.data();
+    double* as = out.as.data();
+    double* bs = out.bs.data();
+    double m11 = i11, m12 = i12, m21 = i21, m22 = i22; // locals: no reloading from this
+    for (size_t i = 0; i < n; ++i) { // no branches, no calls: vectorizes
+      as[i] = m11 * xs[i] + m12 * ys[i];
+      bs[i] = m21 * xs[i] + m22 * ys[i];
+    }
+  }
+
+  // integer coordinates -> points (exactly what the loop above computes)
+  void fromBasis(const VecArray& in, VecArray& out) const {
+    size_t n = in.size();
+    out.xs.resize(n);
+    out.ys.resize(n);
+    const int* as = in.xs.data();
+    const int* bs = in.ys.data();
+    int* xs = out.xs.data();
+    int* ys = out.ys.data();
+    int ax = v1.x, ay = v1.y, bx = v2.x, by = v2.y;
+    for (size_t i = 0; i < n; ++i) {
+      xs[i] = as[i] * ax + bs[i] * bx;
+      ys[i] = as[i] * ay + bs[i] * by;
+    }
+  }
+
+  // coordinates from toBasis -> points, rounded to the nearest integer
+  //   (so toBasis followed by fromBasis gives back the same points)
+  void fromBasis(const CoordArray& in, VecArray& out) const {
+    size_t n = in.size();
+    out.xs.resize(n);
+    out.ys.resize(n);
+    const double* as = in.as.data();
+    const double* bs = in.bs.data();
+    int* xs = out.xs.data();
+    int* ys = out.ys.data();
+    double ax = v1.x, ay = v1.y, bx = v2.x, by = v2.y;
+    for (size_t i = 0; i < n; ++i) {
+      xs[i] = static_cast<int>(std::lround(as[i] * ax + bs[i] * bx));
+      ys[i] = static_cast<int>(std::lround(as[i] * ay + bs[i] * by));
+    }
+  }
+
+  const Vec& getV1() const { return v1; }
+  const Vec& getV2() const { return v2; }
+
+  // Same two operations over a plain range of Vecs (array of structs), 
+  //   for when the data is already in a vector<Vec>.
+  // Still one pass, no temporaries; the compiler can still vectorize it,
+  //   it just has to shuffle x's and y's apart first.
+  void toBasis(const Vec* first, const Vec* last, double* as, double* bs) const {
+    for (; first != last; ++first, ++as, ++bs) {
+      *as = i11 * first->x + i12 * first->y;
+      *bs = i21 * first->x + i22 * first->y;
+    }
+  }
+  void fromBasis(const Vec* first, const Vec* last, Vec* out) const {
+    for (; first != last; ++first, ++out) {
+      *out = Vec{first->x * v1.x + first->y * v2.x, first->x * v1.y + first->y * v2.y};
+    }
+  }
+};
+// compile with optimization so the loops actually get vectorized:
+// g++20m -O3 -march=native ...
+// (add -fopt-info-vec to see which loops the compiler vectorized)
+
+// Benchmark: hand-written loop with Vec operators vs. bulk fromBasis
+import <chrono>;
+import <iostream>;
+int main() {
+  const size_t n = 10'000'000;
+  Basis b{Vec{2, 1}, Vec{-1, 3}};
+  VecArray coords, points;
+  coords.xs.resize(n);
+  coords.ys.resize(n);
+  std::vector<Vec> aos;
+  for (size_t i = 0; i < n; ++i) {
+    coords.xs[i] = i % 1000;
+    coords.ys[i] = i % 777;
+    aos.push_back(Vec{coords.xs[i], coords.ys[i]});
+  }
+
+  using Clock = std::chrono::steady_clock;
+  auto ms = [](auto d) { return std::chrono::duration<double, std::milli>(d).count(); };
+
+  // outputs allocated (and touched) up front, so we time only the math
+  std::vector<Vec> slow(n, Vec{0, 0});
+  points.xs.resize(n);
+  points.ys.resize(n);
+  CoordArray back;
+  back.as.resize(n);
+  back.bs.resize(n);
+  Vec v1{2, 1}, v2{-1, 3};
+  auto t0 = Clock::now();
+  for (size_t i = 0; i < n; ++i) {
+    slow[i] = v1 * aos[i].x + v2 * aos[i].y; // operator* and operator+
+  }
+  auto t1 = Clock::now();
+  b.fromBasis(coords, points);
+  auto t2 = Clock::now();
+  b.toBasis(points, back);
+  auto t3 = Clock::now();
+
+  std::cout << "Vec operators:    " << n / ms(t1 - t0) / 1000 << " Mpoints/s\n"
+            << "fromBasis (bulk): " << n / ms(t2 - t1) / 1000 << " Mpoints/s\n"
+            << "toBasis (bulk):   " << n / ms(t3 - t2) / 1000 << " Mpoints/s\n";
+  // sanity check: going there and back gives the original coordinates
+  std::cout << back.as[12345] << ", " << back.bs[12345] << std::endl; // 345, 690
+}
+// What to expect:
+// -- if operator* and operator+ are defined where the compiler can see them,
+//    at -O3 it inlines them and the "slow" loop gets vectorized too, so the two
+//    are close (both are limited by memory bandwidth at this size)
+// -- if they live in vector-impl.cc (separate compilation, see 5.28), every
+//    point costs 3 real function calls, and the bulk version wins clearly
+// -- toBasis has no Vec-operator equivalent at all: without the precomputed
+//    inverse you would solve a 2x2 system (with a division) for every point
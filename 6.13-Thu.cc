@@ -130,6 +130,81 @@ Vec** vp = new Vec*[15] = {nullptr};
 // the compiler initializes the rest with 0. 
 // Use this technique instead of a loop.
 
+// 4. Option 3 works, but it costs one heap allocation per Vec, 
+//    and the Vecs end up scattered all over the heap. 
+//    Looping over them jumps around in memory (bad for the cache).
+//    Better: one block of raw memory, big enough for 15 Vecs, 
+//    and construct each Vec in place only when we have its arguments.
+//    (uses templates, see 7.02, and placement new)
+import <cstddef>;
+import <limits>;
+import <memory>;
+import <new>;
+import <stdexcept>;
+import <utility>;
+
+template <typename T> class ObjectArray {
+  T* theArray;      // raw storage, NOT constructed T objects
+  size_t cap;       // how many T's fit
+  size_t n = 0;     // how many T's are actually constructed: [0, n)
+
+  static T* allocate(size_t cap) {
+    // cap * sizeof(T) would wrap around and allocate too little
+    if (cap > std::numeric_limits<size_t>::max() / sizeof(T)) throw std::length_error{"ObjectArray: too big"};
+    return static_cast<T*>(::operator new(cap * sizeof(T), std::align_val_t{alignof(T)}));
+  }
+
+public:
+  explicit ObjectArray(size_t cap) : theArray{allocate(cap)}, cap{cap} { } // no T ctor runs
+
+  // builds one more T at the end from ctor args, e.g. a.emplace_back(1, 2)
+  template <typename... Args> T& emplace_back(Args&&... args) {
+    if (n == cap) throw std::length_error{"ObjectArray: full"}; // it never grows
+    T* p = new (theArray + n) T{std::forward<Args>(args)...}; // placement new:
+    // run the ctor on memory we already have, no allocation
+    // if the ctor throws, n is not incremented, so that slot is never destroyed
+    ++n;
+    return *p;
+  }
+
+  // fills the remaining slots with gen(i), e.g. a.generate([](size_t i) { return Vec{int(i), 0}; })
+  template <typename Gen> void generate(Gen gen) {
+    while (n < cap) {
+      new (theArray + n) T{gen(n)};
+      ++n;
+    }
+  }
+
+  ~ObjectArray() {
+    std::destroy(theArray, theArray + n); // only destroys what was constructed
+    ::operator delete(theArray, std::align_val_t{alignof(T)}); // not delete []
+  }
+
+  ObjectArray(const ObjectArray&) = delete; // keep it simple: no copies
+  ObjectArray& operator=(const ObjectArray&) = delete;
+
+  size_t size() const { return n; }
+  size_t capacity() const { return cap; }
+  T& operator[](size_t i) { return theArray[i]; }
+  const T& operator[](size_t i) const { return theArray[i]; }
+  T* begin() { return theArray; }
+  T* end() { return theArray + n; }
+};
+
+// Now Vec still has no default ctor, and we get 15 Vecs side by side:
+ObjectArray<Vec> vectors{15};
+for (int i = 0; i < 15; ++i) {
+  vectors.emplace_back(i, i); // Vec{i, i} built directly in slot i
+}
+// no loop of deletes, the dtor cleans up
+
+// What if a ctor throws halfway, e.g. the 8th element?
+// -- emplace_back/generate never got to ++n for that slot
+// -- so n == 7, and when the ObjectArray is destroyed (stack unwinding),
+//    exactly those 7 Vecs get their dtors run, then the memory is freed.
+// Compare with `new Vec[15]`: there the compiler does this bookkeeping for us.
+// Here we have to count ourselves, that is what n is for.
+
 
 // ********** Const Objects **********
 
@@ -17,6 +17,76 @@ struct Student {
 // Use mutable to indicate that a field does not contribute to 
 //   the logical constness of an object.
 
+// Careful with threads: if two threads call grade() on the same Student
+//   at the same time, both do ++numMethodCalls on the same int.
+//   That is a data race (undefined behaviour), and updates get lost.
+// Making it std::atomic<int> fixes the race, but then every call from every 
+//   thread fights over the same cache line (64 bytes the CPUs pass between
+//   them), and a cheap const method gets many times slower.
+// Better: give each thread its own slot to count in, each slot on its own 
+//   cache line, and only add the slots up when someone asks for the total.
+import <atomic>;
+import <cstddef>;
+
+class CallCounter {
+  static constexpr size_t Slots = 8; // threads share slots round-robin
+  struct alignas(64) Slot {          // 64 bytes: one cache line per slot
+    std::atomic<long long> n = 0;
+  };
+  mutable Slot slots[Slots]; // mutable: counting doesn't change the logical state
+
+  static size_t mySlot() {
+    static std::atomic<size_t> nextThread = 0;
+    thread_local size_t slot = nextThread++ % Slots; // decided once per thread
+    return slot;
+  }
+
+public:
+  CallCounter() = default;
+  // copies start from the other counter's total (like copying the int did)
+  CallCounter(const CallCounter& other) { slots[0].n = other.value(); }
+  CallCounter& operator=(const CallCounter& other) {
+    long long total = other.value();
+    for (auto& s : slots) s.n = 0;
+    slots[0].n = total;
+    return *this;
+  }
+
+  // const, so it can be called from const methods;
+  //   the slots are mutable atomics, so this is not a data race
+  void increment() const {
+    // relaxed: we only need the count to be right, not any ordering with
+    //   other memory. Uncontended, this is a few nanoseconds.
+    slots[mySlot()].n.fetch_add(1, std::memory_order_relaxed);
+  }
+  long long value() const { // sums the slots; exact once the threads are done
+    long long total = 0;
+    for (auto& s : slots) total += s.n.load(std::memory_order_relaxed);
+    return total;
+  }
+};
+
+struct Student {
+  CallCounter numMethodCalls; // no mutable needed, increment() is const
+
+  float grade() const {
+    numMethodCalls.increment();
+    return /*...*/;
+  }
+};
+// Note: one CallCounter is 8 cache lines (512 bytes). Fine for one counter
+//   per class or per hot method:
+struct Student {
+  inline static CallCounter gradeCalls; // counts grade() over all Students
+
+  float grade() const {
+    gradeCalls.increment();
+    return /*...*/;
+  }
+};
+std::cout << Student::gradeCalls.value() << std::endl;
+// For millions of small objects, a counter per object is too big; count per class.
+
 
 // ********** Comparing Objects **********
 
@@ -214,3 +284,362 @@ int List::ith(int i) const {
 }
 // only List can manipulate Node objects 
 // so we can guarantee the invariant that next is either nullptr or allocated by new
+
+
+// ********** Searching a Set of Points: k-d Tree **********
+// operator<=> on Vec orders by x, then y. That's enough to sort Vecs,
+//   but not to answer questions like
+//   -- which points are inside the rectangle [x0, x1] x [y0, y1]?
+//   -- which point is nearest to p?
+// With only <=> we have to look at every point: O(n) per question.
+
+// A k-d tree splits the points at the median x, then each half at its 
+//   median y, then at x again, and so on. A query only walks into the halves
+//   that can possibly contain an answer.
+// We build it once from all the points (static, no insert/erase later).
+// No Nodes or pointers needed: after building, the points are rearranged in
+//   one vector so that the tree is implicit:
+//   -- the range [lo, hi) is a subtree, its split point is at mid = (lo + hi) / 2
+//   -- left subtree is [lo, mid), right subtree is [mid + 1, hi)
+//   -- depth even: split on x, depth odd: split on y
+import <algorithm>;
+import <queue>;
+import <vector>;
+
+class KdTree {
+  std::vector<Vec> pts;
+  static const size_t Leaf = 16; // small ranges are just scanned
+
+  static int coord(const Vec& v, int axis) { return axis == 0 ? v.x : v.y; }
+
+  // O(n) per level with nth_element, log n levels: O(n log n) total
+  void build(size_t lo, size_t hi, int axis) {
+    if (hi - lo <= Leaf) return;
+    size_t mid = (lo + hi) / 2;
+    std::nth_element(pts.begin() + lo, pts.begin() + mid, pts.begin() + hi,
+      [axis](const Vec& a, const Vec& b) { return coord(a, axis) < coord(b, axis); });
+    build(lo, mid, 1 - axis);
+    build(mid + 1, hi, 1 - axis);
+  }
+
+  template <typename Fn> 
+  void range(size_t lo, size_t hi, int axis, const Vec& min, const Vec& max, Fn& f) const {
+    if (hi - lo <= Leaf) {
+      for (size_t i = lo; i < hi; ++i) {
+        if (min.x <= pts[i].x && pts[i].x <= max.x && min.y <= pts[i].y && pts[i].y <= max.y) {
+          f(pts[i]);
+        }
+      }
+      return;
+    }
+    size_t mid = (lo + hi) / 2;
+    const Vec& p = pts[mid];
+    int c = coord(p, axis);
+    if (min.x <= p.x && p.x <= max.x && min.y <= p.y && p.y <= max.y) f(p);
+    // everything left of mid has coord <= c, everything right has coord >= c
+    if (coord(min, axis) <= c) range(lo, mid, 1 - axis, min, max, f);
+    if (c <= coord(max, axis)) range(mid + 1, hi, 1 - axis, min, max, f);
+  }
+
+  // subtract in long long: a.x - b.x can overflow int. The sum of squares
+  //   is exact while coordinates are within +-2^30 (about a billion).
+  static long long dist2(const Vec& a, const Vec& b) {
+    long long dx = static_cast<long long>(a.x) - b.x, dy = static_cast<long long>(a.y) - b.y;
+    return dx * dx + dy * dy;
+  }
+
+  // best: max-heap of the k closest so far, the top is the worst of them
+  using Best = std::priority_queue<std::pair<long long, size_t>>;
+  void nearest(size_t lo, size_t hi, int axis, const Vec& q, size_t k, Best& best) const {
+    auto consider = [&](size_t i) {
+      long long d = dist2(pts[i], q);
+      if (best.size() < k) best.push({d, i});
+      else if (d < best.top().first) { best.pop(); best.push({d, i}); }
+    };
+    if (hi - lo <= Leaf) {
+      for (size_t i = lo; i < hi; ++i) consider(i);
+      return;
+    }
+    size_t mid = (lo + hi) / 2;
+    consider(mid);
+    long long diff = static_cast<long long>(coord(q, axis)) - coord(pts[mid], axis);
+    // search the side q is on first, it most likely has the answers
+    size_t nearLo = diff < 0 ? lo : mid + 1, nearHi = diff < 0 ? mid : hi;
+    size_t farLo = diff < 0 ? mid + 1 : lo, farHi = diff < 0 ? hi : mid;
+    nearest(nearLo, nearHi, 1 - axis, q, k, best);
+    // the other side can only help if the splitting line is closer than our worst
+    if (best.size() < k || diff * diff < best.top().first) {
+      nearest(farLo, farHi, 1 - axis, q, k, best);
+    }
+  }
+
+public:
+  explicit KdTree(std::vector<Vec> points) : pts{std::move(points)} { // bulk build
+    build(0, pts.size(), 0);
+  }
+
+  size_t size() const { return pts.size(); }
+
+  // calls f(v) for every v with min.x <= v.x <= max.x and min.y <= v.y <= max.y
+  template <typename Fn> void forEachInRange(const Vec& min, const Vec& max, Fn f) const {
+    range(0, pts.size(), 0, min, max, f);
+  }
+
+  // the k points closest to q, closest first
+  std::vector<Vec> kNearest(const Vec& q, size_t k) const {
+    Best best;
+    if (k > 0) nearest(0, pts.size(), 0, q, k, best);
+    std::vector<Vec> result(best.size(), Vec{0, 0});
+    for (size_t i = best.size(); i > 0; --i) {
+      result[i - 1] = pts[best.top().second];
+      best.pop();
+    }
+    return result;
+  }
+};
+
+// Benchmark against a linear scan.
+// ./kd 1000000       (10^8 points takes ~800MB for the Vecs alone)
+import <chrono>;
+import <iostream>;
+import <random>;
+import <string>;
+int main(int argc, char* argv[]) {
+  size_t n = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+  std::mt19937 gen{246};
+  std::uniform_int_distribution<int> d{0, 1'000'000};
+  std::vector<Vec> pts;
+  pts.reserve(n);
+  for (size_t i = 0; i < n; ++i) pts.push_back(Vec{d(gen), d(gen)});
+
+  using Clock = std::chrono::steady_clock;
+  auto ms = [](auto d) { return std::chrono::duration<double, std::milli>(d).count(); };
+
+  auto t0 = Clock::now();
+  KdTree tree{pts};
+  std::cout << "build: " << ms(Clock::now() - t0) << "ms" << std::endl;
+
+  // the same random query points for the tree and for the scan
+  const int queries = 100;
+  std::vector<Vec> qs;
+  for (int i = 0; i < queries; ++i) qs.push_back(Vec{d(gen), d(gen)});
+
+  size_t found = 0, scanned = 0;
+  t0 = Clock::now();
+  for (const Vec& lo : qs) {
+    Vec hi{lo.x + 1000, lo.y + 1000};
+    tree.forEachInRange(lo, hi, [&found](const Vec&) { ++found; });
+  }
+  double treeRange = ms(Clock::now() - t0);
+  t0 = Clock::now();
+  for (const Vec& lo : qs) {
+    Vec hi{lo.x + 1000, lo.y + 1000};
+    for (const Vec& v : pts) {
+      if (lo.x <= v.x && v.x <= hi.x && lo.y <= v.y && v.y <= hi.y) ++scanned;
+    }
+  }
+  double scanRange = ms(Clock::now() - t0);
+  std::cout << "range, per query: tree " << treeRange / queries << "ms, scan " 
+            << scanRange / queries << "ms (" << found << " / " << scanned << " hits)" << std::endl;
+
+  // k nearest: the scan keeps the k best in a max-heap, like the tree does
+  const size_t k = 10;
+  double treeKnn = 0, scanKnn = 0;
+  bool same = true;
+  for (const Vec& q : qs) {
+    auto d2 = [&q](const Vec& v) { 
+      long long dx = static_cast<long long>(v.x) - q.x, dy = static_cast<long long>(v.y) - q.y;
+      return dx * dx + dy * dy;
+    };
+    t0 = Clock::now();
+    std::vector<Vec> a = tree.kNearest(q, k);
+    treeKnn += ms(Clock::now() - t0);
+    t0 = Clock::now();
+    std::priority_queue<long long> best;
+    for (const Vec& v : pts) {
+      long long dv = d2(v);
+      if (best.size() < k) best.push(dv);
+      else if (dv < best.top()) { best.pop(); best.push(dv); }
+    }
+    scanKnn += ms(Clock::now() - t0);
+    // compare the k-th distance (ties may pick different points)
+    if (d2(a.back()) != best.top()) same = false;
+  }
+  std::cout << k << "-nearest, per query: tree " << treeKnn / queries << "ms, scan " 
+            << scanKnn / queries << "ms" << (same ? "" : " MISMATCH") << std::endl;
+}
+
+
+// ********** Hashing Vecs: a Flat Hash Set **********
+// To remove duplicate points with only <=>, we use std::set<Vec> (or sort).
+// std::set is a balanced tree: every insert follows O(log n) pointers
+//   to nodes scattered on the heap, and allocates one node per Vec.
+// A hash table finds the spot for a Vec directly from its hash: O(1) expected.
+
+// Step 1: tell the standard library how to hash a Vec, 
+//   by specializing the std::hash template (then unordered_set<Vec> works too)
+import <bit>;
+import <cstdint>;
+import <functional>;
+import <vector>;
+
+template <> struct std::hash<Vec> {
+  size_t operator()(const Vec& v) const noexcept {
+    // pack x and y into 64 bits, then mix so that nearby points 
+    //   get very different hashes (multiply by a large odd constant)
+    uint64_t k = (uint64_t{static_cast<uint32_t>(v.x)} << 32) | static_cast<uint32_t>(v.y);
+    k *= 0x9E3779B97F4A7C15ULL;
+    return k ^ (k >> 32);
+  }
+};
+
+// Step 2: the table itself.
+// std::unordered_set is also a "node" container (one allocation per element,
+//   a linked list per bucket). Instead we use open addressing: 
+//   keys live directly in one array, and a collision just means 
+//   "try the next slot".
+// Next to the keys we keep one control byte per slot:
+//   -- Empty (0x80): the slot is free
+//   -- otherwise: the low 7 bits of the key's hash
+// Slots are looked at in groups of 16. The 16 control bytes of a group fit 
+//   in one 128-bit SSE2 register, so one compare instruction checks all 16 
+//   slots at once. Only slots whose 7 bits match need a real == on the Vec.
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+template <typename V> class FlatVecMap {
+  static constexpr size_t Group = 16;
+  static constexpr int8_t Empty = -128; // 0x80, never equal to a 7-bit hash
+
+  std::vector<int8_t> ctrl;  // one control byte per slot
+  std::vector<Vec> keys;
+  std::vector<V> vals;
+  size_t mask = 0;           // number of groups - 1 (a power of 2 minus 1)
+  size_t n = 0;
+
+  // bit i is set if control byte i of the group equals b
+  unsigned matches(size_t group, int8_t b) const {
+    const int8_t* g = ctrl.data() + group * Group;
+#ifdef __SSE2__
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(g));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(b)));
+#else
+    unsigned bits = 0;
+    for (size_t i = 0; i < Group; ++i) bits |= unsigned{g[i] == b} << i;
+    return bits;
+#endif
+  }
+
+  // Finds v's slot, or claims an empty one for it. Returns {slot, inserted}.
+  std::pair<size_t, bool> findOrClaim(const Vec& v) {
+    size_t h = std::hash<Vec>{}(v);
+    int8_t h2 = h & 0x7F;         // 7 bits stored in the control byte
+    size_t group = (h >> 7) & mask; // the rest picks the first group to look in
+    for (size_t step = 1; ; ++step) {
+      for (unsigned m = matches(group, h2); m; m &= m - 1) { // each set bit
+        size_t slot = group * Group + std::countr_zero(m);
+        if (keys[slot] == v) return {slot, false};
+      }
+      if (unsigned e = matches(group, Empty)) { // not in the table
+        size_t slot = group * Group + std::countr_zero(e);
+        ctrl[slot] = h2;
+        keys[slot] = v;
+        ++n;
+        return {slot, true};
+      }
+      group = (group + step) & mask; // group full: probe further (triangular steps)
+    }
+  }
+
+  void grow() {
+    size_t groups = ctrl.empty() ? 1 : (mask + 1) * 2;
+    std::vector<int8_t> oldCtrl(groups * Group, Empty);
+    std::vector<Vec> oldKeys(groups * Group, Vec{0, 0});
+    std::vector<V> oldVals(groups * Group);
+    oldCtrl.swap(ctrl);
+    oldKeys.swap(keys);
+    oldVals.swap(vals);
+    mask = groups - 1;
+    n = 0;
+    for (size_t i = 0; i < oldCtrl.size(); ++i) {
+      if (oldCtrl[i] != Empty) {
+        vals[findOrClaim(oldKeys[i]).first] = std::move(oldVals[i]);
+      }
+    }
+  }
+
+public:
+  // keep the table at most 7/8 full, otherwise probes get long
+  V& operator[](const Vec& v) {
+    if ((n + 1) * 8 > ctrl.size() * 7) grow();
+    return vals[findOrClaim(v).first];
+  }
+  bool insert(const Vec& v) {
+    if ((n + 1) * 8 > ctrl.size() * 7) grow();
+    return findOrClaim(v).second;
+  }
+  size_t size() const { return n; }
+  void reserve(size_t count) { // avoids rehashing while filling
+    while (ctrl.size() * 7 < count * 8) grow();
+  }
+  // calls f(key, value) for every entry
+  template <typename Fn> void forEach(Fn f) const {
+    for (size_t i = 0; i < ctrl.size(); ++i) {
+      if (ctrl[i] != Empty) f(keys[i], vals[i]);
+    }
+  }
+};
+// No erase: for deduplicating and counting we never remove.
+// (Erase would need a "deleted" control byte so that probing doesn't stop early.)
+
+// A set is a map with nothing in it
+struct NoValue { };
+using FlatVecSet = FlatVecMap<NoValue>;
+
+// Benchmark: deduplicate n random points (many repeats), then count them
+// ./dedup 100000000
+import <algorithm>;
+import <chrono>;
+import <iostream>;
+import <random>;
+import <set>;
+import <string>;
+import <unordered_set>;
+int main(int argc, char* argv[]) {
+  size_t n = argc > 1 ? std::stoull(argv[1]) : 10'000'000;
+  std::mt19937 gen{246};
+  std::uniform_int_distribution<int> d{0, 2000}; // ~4M distinct points
+  std::vector<Vec> pts;
+  pts.reserve(n);
+  for (size_t i = 0; i < n; ++i) pts.push_back(Vec{d(gen), d(gen)});
+
+  using Clock = std::chrono::steady_clock;
+  auto ms = [](auto d) { return std::chrono::duration<double, std::milli>(d).count(); };
+
+  auto t0 = Clock::now();
+  std::set<Vec> tree{pts.begin(), pts.end()};
+  std::cout << "std::set:           " << ms(Clock::now() - t0) << "ms, " << tree.size() << std::endl;
+
+  t0 = Clock::now();
+  std::vector<Vec> sorted = pts;
+  std::sort(sorted.begin(), sorted.end());
+  sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+  std::cout << "sort + unique:      " << ms(Clock::now() - t0) << "ms, " << sorted.size() << std::endl;
+
+  t0 = Clock::now();
+  std::unordered_set<Vec> uset{pts.begin(), pts.end()};
+  std::cout << "std::unordered_set: " << ms(Clock::now() - t0) << "ms, " << uset.size() << std::endl;
+
+  t0 = Clock::now();
+  FlatVecSet flat;
+  for (const Vec& v : pts) flat.insert(v);
+  std::cout << "FlatVecSet:         " << ms(Clock::now() - t0) << "ms, " << flat.size() << std::endl;
+
+  t0 = Clock::now();
+  FlatVecMap<unsigned> counts;
+  for (const Vec& v : pts) ++counts[v]; // how often each point occurs
+  unsigned most = 0;
+  counts.forEach([&most](const Vec&, unsigned c) { most = std::max(most, c); });
+  std::cout << "FlatVecMap count:   " << ms(Clock::now() - t0) << "ms, max " << most << std::endl;
+}
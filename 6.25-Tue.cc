@@ -244,3 +244,309 @@ class Text : public Book {
 // step2 : Book{title, author, length}
 // step3 : topic{topic}
 // step4 : { } 
+
+
+// ********** Sharing Repeated Strings: Interning **********
+// Every Book carries its own copies of title and author (and topic / hero).
+// In a big catalog the same authors, topics and heroes appear over and over:
+//   a million books by a few thousand authors store each name thousands of times.
+// Interning: keep ONE copy of each distinct string in a pool, and let the
+//   books store a small handle (an index into the pool) instead.
+// -- equal strings always get the same handle, so comparing two authors 
+//    is comparing two ints, not two strings character by character
+// -- a handle is 4 bytes; a std::string is 32 bytes, plus a heap block 
+//    if the text is longer than 15 chars
+import <cstdint>;
+import <memory>;
+import <string>;
+import <string_view>;
+import <unordered_map>;
+import <vector>;
+
+struct Str { // handle to an interned string
+  uint32_t id;
+  bool operator==(const Str&) const = default; // handle compare
+};
+
+class StringPool {
+  static constexpr size_t ChunkSize = 64 * 1024;
+  // characters live in big chunks that are never moved or freed while the 
+  //   pool lives, so string_views into them stay valid (stable)
+  std::vector<std::unique_ptr<char[]>> chunks;
+  size_t used = ChunkSize; // bytes used in the last chunk (full = get a new one)
+  size_t arenaBytes = 0;
+  std::vector<std::string_view> strings;              // id -> text
+  std::unordered_map<std::string_view, uint32_t> ids; // text -> id
+
+  std::string_view store(std::string_view s) { // copy s into the arena
+    if (s.empty()) return {}; // nothing to copy (and maybe no chunk yet)
+    if (s.size() > ChunkSize) { // too big for a chunk: give it its own,
+      // put at the front so the partly filled chunk stays last
+      chunks.insert(chunks.begin(), std::make_unique<char[]>(s.size()));
+      arenaBytes += s.size();
+      s.copy(chunks.front().get(), s.size());
+      return {chunks.front().get(), s.size()};
+    }
+    if (used + s.size() > ChunkSize) {
+      chunks.push_back(std::make_unique<char[]>(ChunkSize));
+      arenaBytes += ChunkSize;
+      used = 0;
+    }
+    char* p = chunks.back().get() + used;
+    s.copy(p, s.size());
+    used += s.size();
+    return {p, s.size()};
+  }
+
+public:
+  Str intern(std::string_view s) {
+    if (auto it = ids.find(s); it != ids.end()) return Str{it->second}; // seen before
+    std::string_view stored = store(s);
+    uint32_t id = strings.size();
+    strings.push_back(stored);
+    ids.emplace(stored, id); // key points into the arena, not at the caller's s
+    return Str{id};
+  }
+  std::string_view view(Str s) const { return strings[s.id]; }
+  size_t distinct() const { return strings.size(); }
+  size_t bytes() const { // roughly: chunks + id table + hash table
+    return arenaBytes + strings.capacity() * sizeof(std::string_view)
+         + ids.bucket_count() * sizeof(void*) 
+         + ids.size() * (sizeof(std::string_view) + sizeof(uint32_t) + 2 * sizeof(void*));
+  }
+};
+
+// All books share one pool. Not thread-safe: intern from one thread at a time.
+StringPool& bookStrings() {
+  static StringPool pool; // created on first use
+  return pool;
+}
+
+class Book {
+  Str title, author;
+protected:
+  int length;
+public:
+  Book(std::string_view title, std::string_view author, int length) :
+    title{bookStrings().intern(title)}, author{bookStrings().intern(author)}, length{length} { }
+  std::string_view getTitle() const { return bookStrings().view(title); }
+  std::string_view getAuthor() const { return bookStrings().view(author); }
+  int getLength() const { return length; }
+  bool sameAuthor(const Book& other) const { return author == other.author; } // int compare
+};
+class Text : public Book {
+  Str topic;
+public:
+  Text(std::string_view title, std::string_view author, int length, std::string_view topic) :
+    Book{title, author, length}, topic{bookStrings().intern(topic)} { }
+  std::string_view getTopic() const { return bookStrings().view(topic); }
+};
+class Comic : public Book {
+  Str hero;
+public:
+  Comic(std::string_view title, std::string_view author, int length, std::string_view hero) :
+    Book{title, author, length}, hero{bookStrings().intern(hero)} { }
+  std::string_view getHero() const { return bookStrings().view(hero); }
+};
+// Note: getTitle() returns a string_view, valid as long as the pool lives
+//   (i.e., the whole program). Copy it into a std::string to keep or modify it.
+
+// Memory report on a made-up but realistic catalog: 
+//   titles mostly unique, 20000 authors (a few very prolific), 300 topics, 2000 heroes
+import <iostream>;
+import <random>;
+int main() {
+  const int n = 2'000'000;
+  std::mt19937 gen{246};
+  auto name = [](const char* kind, size_t i) { return std::string{kind} + " number " + std::to_string(i); };
+  std::vector<Text> texts;
+  std::vector<Comic> comics;
+  size_t stringBytes = 0; // what the std::string fields would have cost
+  auto cost = [](const std::string& s) { // libstdc++: 32 bytes, heap only past 15 chars
+    return sizeof(std::string) + (s.size() > 15 ? s.size() + 1 : 0);
+  };
+  std::geometric_distribution<int> prolific{0.0005}; // small author ids are common
+  for (int i = 0; i < n; ++i) {
+    std::string title = name("Volume", i), author = name("Author", prolific(gen) % 20000);
+    if (i % 2) {
+      std::string topic = name("Topic", gen() % 300);
+      texts.emplace_back(title, author, 100, topic);
+      stringBytes += cost(title) + cost(author) + cost(topic);
+    } else {
+      std::string hero = name("Hero", gen() % 2000);
+      comics.emplace_back(title, author, 30, hero);
+      stringBytes += cost(title) + cost(author) + cost(hero);
+    }
+  }
+  size_t handleBytes = n * 3 * sizeof(Str) + bookStrings().bytes();
+  std::cout << "std::string fields: " << stringBytes / (1 << 20) << " MB\n"
+            << "interned:           " << handleBytes / (1 << 20) << " MB (" 
+            << bookStrings().distinct() << " distinct strings)\n";
+}
+// Most of what remains is the titles: they are (almost) all different, so 
+//   interning can't share them, it only stores them more compactly.
+//   The big savings are the author/topic/hero fields, which shrink to 4 bytes each.
+
+
+// ********** Saving the Catalog: a Binary File Format **********
+// Writing books out field by field through streams (out << title << ...)
+//   and reading them back means parsing every string and building every 
+//   object again, before we can look at a single book.
+// Instead, a file laid out so that it can be used right where it is:
+//   | header | records: one fixed-size record per book | string table |
+// -- every record has the same size, so record i is at a known position
+// -- strings are not in the records; a record holds string numbers, and the
+//    string table maps numbers to text (each distinct string stored once,
+//    using the StringPool from above)
+// -- a record is tagged with its type (Book / Text / Comic), and its "extra"
+//    string is the topic or the hero
+// Reading = memory-map the file (the OS loads pages only when touched) and
+//   look at the records in place. No Book objects are created; we hand out
+//   small "views" that read the fields straight from the file.
+import <cstring>;
+import <fstream>;
+#include <fcntl.h>    // POSIX: open
+#include <sys/mman.h> // POSIX: mmap, munmap
+#include <unistd.h>   // POSIX: close
+
+enum class BookType : uint8_t { Book, Text, Comic };
+
+struct BookRecord {        // 20 bytes, same for every book
+  BookType type;
+  uint8_t unused[3] = {};  // padding, written as zeros
+  int32_t length;
+  uint32_t title, author;  // string numbers
+  uint32_t extra;          // topic (Text) or hero (Comic); unused for Book
+};
+
+struct CatalogHeader {
+  char magic[8];           // "BOOKCAT"
+  uint32_t version;        // 1
+  uint32_t numRecords;
+  uint32_t numStrings;
+  uint32_t stringBytes;    // size of all string text together
+};
+// after the header: numRecords BookRecords, then numStrings + 1 uint32 
+//   offsets, then stringBytes chars. String i is [offsets[i], offsets[i + 1]).
+// Ints are in this machine's byte order (little-endian on x86 and ARM).
+
+class CatalogWriter {
+  StringPool strings; // numbers strings as we see them
+  std::vector<BookRecord> records;
+
+  BookRecord record(BookType t, const Book& b, std::string_view extra) {
+    return {t, {}, b.getLength(), strings.intern(b.getTitle()).id, strings.intern(b.getAuthor()).id,
+            strings.intern(extra).id};
+  }
+
+public:
+  void add(const Book& b) { records.push_back(record(BookType::Book, b, "")); }
+  void add(const Text& t) { records.push_back(record(BookType::Text, t, t.getTopic())); }
+  void add(const Comic& c) { records.push_back(record(BookType::Comic, c, c.getHero())); }
+
+  bool write(const std::string& path) {
+    std::vector<uint32_t> offsets{0};
+    for (uint32_t i = 0; i < strings.distinct(); ++i) {
+      offsets.push_back(offsets.back() + strings.view(Str{i}).size());
+    }
+    CatalogHeader h{"BOOKCAT", 1, static_cast<uint32_t>(records.size()), 
+                    static_cast<uint32_t>(strings.distinct()), offsets.back()};
+    std::ofstream out{path, std::ios::binary};
+    out.write(reinterpret_cast<const char*>(&h), sizeof h);
+    out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(BookRecord));
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint32_t));
+    for (uint32_t i = 0; i < strings.distinct(); ++i) {
+      std::string_view s = strings.view(Str{i});
+      out.write(s.data(), s.size());
+    }
+    return static_cast<bool>(out);
+  }
+};
+
+class MappedCatalog {
+  void* map = nullptr;
+  size_t mapSize = 0;
+  const CatalogHeader* header = nullptr;
+  const BookRecord* records = nullptr;
+  const uint32_t* offsets = nullptr;
+  const char* text = nullptr;
+
+public:
+  // a Book-like view of record i; valid while the MappedCatalog is open
+  class BookView {
+    const MappedCatalog* cat;
+    const BookRecord* r;
+  public:
+    BookView(const MappedCatalog* cat, const BookRecord* r) : cat{cat}, r{r} { }
+    BookType type() const { return r->type; }
+    std::string_view getTitle() const { return cat->string(r->title); }
+    std::string_view getAuthor() const { return cat->string(r->author); }
+    std::string_view getTopic() const { return r->type == BookType::Text ? cat->string(r->extra) : ""; }
+    std::string_view getHero() const { return r->type == BookType::Comic ? cat->string(r->extra) : ""; }
+    int getLength() const { return r->length; }
+    bool isHeavy() const { // same rules as the classes, chosen by the tag
+      switch (r->type) {
+        case BookType::Text:  return r->length > 500;
+        case BookType::Comic: return r->length > 30;
+        default:              return r->length > 200;
+      }
+    }
+  };
+
+  MappedCatalog() = default;
+  ~MappedCatalog() { if (map) munmap(map, mapSize); }
+  MappedCatalog(const MappedCatalog&) = delete;
+  MappedCatalog& operator=(const MappedCatalog&) = delete;
+
+  // Maps the file and checks that the header fits the file size. 
+  //   O(1): nothing is read except the header.
+  bool open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    off_t size = lseek(fd, 0, SEEK_END);
+    void* m = size >= static_cast<off_t>(sizeof(CatalogHeader)) 
+              ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (m == MAP_FAILED) return false;
+    auto h = static_cast<const CatalogHeader*>(m);
+    size_t expected = sizeof(CatalogHeader) + size_t{h->numRecords} * sizeof(BookRecord)
+                    + (size_t{h->numStrings} + 1) * sizeof(uint32_t) + h->stringBytes;
+    if (std::memcmp(h->magic, "BOOKCAT", 8) != 0 || h->version != 1 || expected != static_cast<size_t>(size)) {
+      munmap(m, size);
+      return false;
+    }
+    if (map) munmap(map, mapSize);
+    map = m;
+    mapSize = size;
+    header = h;
+    records = reinterpret_cast<const BookRecord*>(h + 1);
+    offsets = reinterpret_cast<const uint32_t*>(records + h->numRecords);
+    text = reinterpret_cast<const char*>(offsets + h->numStrings + 1);
+    return true;
+  }
+
+  size_t size() const { return header ? header->numRecords : 0; }
+  BookView operator[](size_t i) const { return BookView{this, records + i}; }
+
+  // checked: a damaged file gives empty strings, not reads past the end
+  std::string_view string(uint32_t i) const {
+    if (i >= header->numStrings) return "";
+    uint32_t b = offsets[i], e = offsets[i + 1];
+    if (b > e || e > header->stringBytes) return "";
+    return {text + b, e - b};
+  }
+};
+
+// client
+CatalogWriter w;
+w.add(Text{"Algorithms", "CLRS", 1300, "CS"});
+w.add(Comic{"Spider-Man", "Stan Lee", 32, "Spider-Man"}); // one copy of "Spider-Man"
+w.write("catalog.bin");
+
+MappedCatalog cat;
+if (cat.open("catalog.bin")) { // milliseconds, however big the file is
+  for (size_t i = 0; i < cat.size(); ++i) {
+    std::cout << cat[i].getTitle() << " by " << cat[i].getAuthor() 
+              << (cat[i].isHeavy() ? " (heavy)" : "") << std::endl;
+  }
+}
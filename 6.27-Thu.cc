@@ -199,3 +199,112 @@ Coop c;
 
 // 20-purevit 
 // big five associated with inheritance
+
+
+// ********** Many Students: Grouping by Type **********
+// Computing fees for a million students through Student*:
+std::vector<Student*> students; // a mix of Regular and Coop, in any order
+long long total = 0;
+for (Student* s : students) total += s->fees();
+// Every s->fees() is a virtual call: load the object's vtable pointer, 
+//   load the function address, jump there. Since Regulars and Coops are 
+//   mixed, the CPU can't guess where the jump goes, and every object is a 
+//   separate heap allocation somewhere else in memory.
+
+// If we keep each concrete type in its own vector (bucket), then within a 
+//   bucket we know the exact type, and the compiler can call 
+//   Regular::fees() directly (even inline it) instead of going through the vtable.
+// `final` (see Destruction Revisited) is what makes this safe: 
+//   no class can derive from Regular, so a Regular& really is a Regular, 
+//   and r.fees() can only mean Regular::fees().
+class Student {
+protected:
+  int numCourses;
+public:
+  explicit Student(int numCourses) : numCourses{numCourses} { }
+  virtual int fees() const = 0;
+  virtual ~Student() = default;
+};
+class Regular final : public Student {
+public:
+  using Student::Student; // same ctor as Student
+  int fees() const override { return numCourses * 700; }
+};
+class Coop final : public Student {
+public:
+  using Student::Student;
+  int fees() const override { return numCourses * 700 + 750; } // plus co-op fee
+};
+
+class StudentBuckets {
+  std::vector<Regular> regulars; // stored by value, side by side
+  std::vector<Coop> coops;
+
+public:
+  void add(const Regular& r) { regulars.push_back(r); }
+  void add(const Coop& c) { coops.push_back(c); }
+  size_t size() const { return regulars.size() + coops.size(); }
+
+  // f(student, fees) for everyone, bucket by bucket.
+  // r is a const Regular&, so r.fees() is a direct call, no vtable.
+  template <typename Fn> void forEachFees(Fn f) const {
+    for (const Regular& r : regulars) f(r, r.fees());
+    for (const Coop& c : coops) f(c, c.fees());
+  }
+  long long totalFees() const {
+    long long total = 0;
+    forEachFees([&total](const Student&, int fee) { total += fee; });
+    return total;
+  }
+
+  // Generic code still works: f gets a Student&, and calls through it are
+  //   virtual as usual, so both ways give the same answers.
+  template <typename Fn> void forEachStudent(Fn f) const {
+    for (const Regular& r : regulars) f(static_cast<const Student&>(r));
+    for (const Coop& c : coops) f(static_cast<const Student&>(c));
+  }
+};
+// Note: the order is "all Regulars, then all Coops", not the order of add().
+
+// Benchmark
+import <algorithm>;
+import <chrono>;
+import <iostream>;
+import <memory>;
+import <random>;
+import <vector>;
+int main() {
+  const int n = 1'000'000;
+  std::mt19937 gen{246};
+  std::vector<std::unique_ptr<Student>> mixed; // the usual way, in arrival order
+  StudentBuckets buckets;
+  for (int i = 0; i < n; ++i) {
+    int courses = 1 + gen() % 6;
+    if (gen() % 2) {
+      mixed.push_back(std::make_unique<Regular>(courses));
+      buckets.add(Regular{courses});
+    } else {
+      mixed.push_back(std::make_unique<Coop>(courses));
+      buckets.add(Coop{courses});
+    }
+  }
+
+  using Clock = std::chrono::steady_clock;
+  auto ms = [](auto d) { return std::chrono::duration<double, std::milli>(d).count(); };
+
+  auto t0 = Clock::now();
+  long long viaPointers = 0;
+  for (auto& s : mixed) viaPointers += s->fees();
+  double tPointers = ms(Clock::now() - t0);
+
+  t0 = Clock::now();
+  long long viaBuckets = buckets.totalFees();
+  double tBuckets = ms(Clock::now() - t0);
+
+  long long viaInterface = 0;
+  buckets.forEachStudent([&viaInterface](const Student& s) { viaInterface += s.fees(); });
+
+  std::cout << "Student* loop: " << tPointers << "ms, buckets: " << tBuckets << "ms\n"
+            << (viaPointers == viaBuckets && viaBuckets == viaInterface ? "same" : "DIFFERENT") 
+            << " totals: " << viaBuckets << std::endl;
+}
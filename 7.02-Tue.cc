@@ -51,6 +51,53 @@ for (auto n : ints) {
 //   transformation and then compiles the resulting code as usual
 
 
+// ********** Policies as Template Arguments: Grading Schemes **********
+// Student::grade() hard-codes the weights 0.4 / 0.2 / 0.4.
+// Different courses weigh things differently. A runtime table of weights
+//   works, but then every grade() reads 3 weights from memory and looks up
+//   which table to use, once per student.
+// Templates can be parameterized by any type, not just the type of data 
+//   we store. Here the type is a "policy": a small struct that only holds 
+//   the weights, as compile-time constants.
+struct Standard   { static constexpr double assns = 0.4, mt = 0.2, final = 0.4; };
+struct NoMidterm  { static constexpr double assns = 0.5, mt = 0.0, final = 0.5; };
+struct FinalHeavy { static constexpr double assns = 0.3, mt = 0.2, final = 0.5; };
+
+template <typename Policy> 
+float grade(const Student& s) {
+  // Policy::assns etc. are known when the template is specialized, 
+  //   so they become constants in the machine code (constant folding),
+  //   exactly as if we had typed the numbers in. No lookup at run time.
+  return s.assns * Policy::assns + s.mt * Policy::mt + s.final * Policy::final;
+}
+Student s{60, 70, 80};
+grade<Standard>(s);   // same expression and result as s.grade()
+grade<FinalHeavy>(s); // 0.3 * 60 + 0.2 * 70 + 0.5 * 80 = 72
+
+// Grading a whole roster with one policy: the loop body has no branches 
+//   and no loads of weights, so the compiler can also vectorize it.
+import <vector>;
+template <typename Policy> 
+void gradeAll(const std::vector<Student>& roster, std::vector<float>& out) {
+  out.resize(roster.size());
+  for (size_t i = 0; i < roster.size(); ++i) out[i] = grade<Policy>(roster[i]);
+}
+
+// The scheme is often only known at run time (read from a course file).
+// Then we choose ONCE per roster, not once per student:
+enum class Scheme { Standard, NoMidterm, FinalHeavy };
+void gradeAll(Scheme scheme, const std::vector<Student>& roster, std::vector<float>& out) {
+  switch (scheme) { // one dispatch per batch
+    case Scheme::Standard:   gradeAll<Standard>(roster, out); break;
+    case Scheme::NoMidterm:  gradeAll<NoMidterm>(roster, out); break;
+    case Scheme::FinalHeavy: gradeAll<FinalHeavy>(roster, out); break;
+  }
+}
+// Each case is a different specialization of gradeAll: the compiler 
+//   generates one copy of the loop per policy, each with its own constants.
+// Adding a scheme = one new policy struct + one new case.
+
+
 // ********** Standard Template Library (STL) **********
 // STL is a large collection of useful templates.
 // Example: vectors - dynamic length arrays
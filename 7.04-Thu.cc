@@ -167,3 +167,633 @@ public:
 //    delegating to the object it decorates
 // 5. objects can be decorated at any time so we can decorate objects at runtime
 // 6. Decorator pattern is an alternative to subclassing for extending bahavior
+
+
+// ********** 3. Observer Example: Live Grade Statistics **********
+// Problem: a report shows the class mean, median and a grade histogram.
+// Every time one mark changes, it rescans all Students and calls grade().
+// O(n) per change, even though only one grade moved.
+
+// Instead, make each Student a subject, and the statistics an observer
+//   that updates its totals when told about the change.
+// This is the "push" variant from point 5 above: the subject passes the 
+//   old value along, because the observer needs it to undo the old grade.
+
+// Trick: with marks 0..100, 
+//   5 * grade = 5 * (0.4 * assns + 0.2 * mt + 0.4 * final) = 2 * assns + mt + 2 * final
+//   is an integer between 0 and 500. Call it the student's points.
+// So there are only 501 possible grades, and we can count how many
+//   students have each one.
+import <algorithm>;
+import <cmath>;
+import <stdexcept>;
+import <vector>;
+
+class Student;
+
+class StudentObserver {
+public:
+  // s changed; oldPoints is what s.points() was before the change
+  virtual void notify(const Student& s, int oldPoints) = 0;
+  virtual ~StudentObserver() = default;
+};
+
+class Student {
+  int assns, mt, final; // each 0..100
+  std::vector<StudentObserver*> observers;
+
+  void notifyObservers(int oldPoints) {
+    for (auto ob : observers) ob->notify(*this, oldPoints);
+  }
+
+public:
+  // Throws std::out_of_range unless every mark is 0..100: GradeStats counts
+  //   points 0..500 and has no room for any others.
+  static int checked(int mark) {
+    if (mark < 0 || mark > 100) throw std::out_of_range{"mark not in 0..100"};
+    return mark;
+  }
+  Student(int assns, int mt, int final) : 
+    assns{checked(assns)}, mt{checked(mt)}, final{checked(final)} { }
+  // A copy would have the same observers, but none of them counted it.
+  Student(const Student&) = delete;
+  Student& operator=(const Student&) = delete;
+  void attach(StudentObserver* ob) { observers.push_back(ob); }
+  void detach(StudentObserver* ob) { std::erase(observers, ob); }
+
+  int points() const { return 2 * assns + mt + 2 * final; } // 5 * grade, exact
+  float grade() const { return assns * 0.4 + mt * 0.2 + final * 0.4; }
+
+  // the mutators are where the state changes, so they notify
+  void setAssns(int a) { int old = points(); assns = checked(a); notifyObservers(old); }
+  void setMt(int m)    { int old = points(); mt = checked(m);    notifyObservers(old); }
+  void setFinal(int f) { int old = points(); final = checked(f); notifyObservers(old); }
+};
+
+class GradeStats : public StudentObserver {
+  static constexpr int MaxPoints = 500;
+  static constexpr int Buckets = 10; // histogram: [0, 10), [10, 20), ..., [90, 100]
+
+  // count[p] = number of students with p points, kept in a Fenwick tree 
+  //   (binary indexed tree): one update and one "how many have <= p points?"
+  //   each take O(log 501) steps instead of O(n).
+  std::vector<int> tree = std::vector<int>(MaxPoints + 2, 0);
+  std::vector<int> hist = std::vector<int>(Buckets, 0);
+  long long total = 0; // sum of everyone's points
+  int n = 0;
+
+  void count(int p, int delta) {
+    for (int i = p + 1; i <= MaxPoints + 1; i += i & -i) tree[i] += delta;
+    hist[std::min(p / 50, Buckets - 1)] += delta;
+    total += static_cast<long long>(p) * delta;
+    n += delta;
+  }
+
+  // points of the k-th lowest student (k from 0), by walking down the tree
+  int kth(int k) const {
+    int pos = 0;
+    for (int step = 512; step > 0; step /= 2) { // 512 = first power of 2 > 501
+      if (pos + step <= MaxPoints + 1 && tree[pos + step] <= k) {
+        pos += step;
+        k -= tree[pos];
+      }
+    }
+    return pos; // tree index pos + 1 holds points pos
+  }
+
+public:
+  void add(Student& s) { s.attach(this); count(s.points(), +1); }
+  void remove(Student& s) { s.detach(this); count(s.points(), -1); }
+
+  void notify(const Student& s, int oldPoints) override { // O(log 501)
+    count(oldPoints, -1);
+    count(s.points(), +1);
+  }
+
+  int size() const { return n; }
+  double mean() const { return n ? total / 5.0 / n : 0; }
+  double median() const {
+    if (n == 0) return 0;
+    return (kth((n - 1) / 2) + kth(n / 2)) / 10.0; // average of the middle two, / 5
+  }
+  // nearest-rank percentile, 0 < p <= 100: the grade at least p% of students have 
+  //   less than or equal to
+  double percentile(double p) const {
+    if (n == 0) return 0;
+    p = std::clamp(p, 0.0, 100.0);
+    int k = static_cast<int>(std::ceil(p * n / 100)); // exact for whole p (see 7.25)
+    return kth(std::max(k, 1) - 1) / 5.0;
+  }
+  const std::vector<int>& histogram() const { return hist; }
+};
+
+// client
+Student a{60, 70, 80}, b{90, 85, 100}, c{40, 50, 45};
+GradeStats stats;
+stats.add(a);
+stats.add(b);
+stats.add(c);
+std::cout << stats.mean() << " " << stats.median() << std::endl; // 69 70
+c.setFinal(90); // one O(log) update, no rescan
+std::cout << stats.mean() << " " << stats.median() << std::endl; // 75 70
+std::cout << stats.percentile(90) << std::endl; // 93
+// Important: detach (remove) before a Student is destroyed, 
+//   otherwise nobody undoes its points. And GradeStats must outlive the
+//   Students it is attached to (same rule as any Subject/Observer pair).
+
+
+// ********** 4. Observer Example: Keyed Subscriptions (HorseRace) **********
+// The HorseRace from the diagram in 1:
+class Observer {
+public:
+  virtual void notify() = 0;
+  virtual ~Observer() = default;
+};
+
+class Subject {
+  std::vector<Observer*> observers;
+public:
+  void attach(Observer* ob) { observers.push_back(ob); }
+  void detach(Observer* ob) { std::erase(observers, ob); }
+  void notifyObservers() { for (auto ob : observers) ob->notify(); }
+  virtual ~Subject() = 0;
+};
+Subject::~Subject() { }
+
+class Bettor : public Observer {
+  HorseRace* hr;
+  std::string name, myHorse;
+public:
+  void notify() override {
+    if (hr->getLastWinner() == myHorse) std::cout << name << " wins!" << std::endl;
+  }
+};
+// Every Bettor is notified after every race, and all but the few who bet on
+//   the winner throw the notification away. With 100000 bettors, that is 
+//   100000 virtual calls and string compares per race to pay a handful of them.
+
+// Instead, let an observer say what it is interested in: attach with a key
+//   (here the horse name). notifyObservers(key) notifies only the observers 
+//   attached with that key, plus those attached without one (they want 
+//   everything, as before). The Subject keeps one list per key, in a hash map,
+//   so finding the list is O(1) and the cost is O(interested observers).
+// The Subject still knows nothing about its observers except notify() 
+//   (point 2 in 1): the key is just a string the Subject and the observer agree on.
+import <iostream>;
+import <istream>;
+import <string>;
+import <unordered_map>;
+import <vector>;
+
+class Observer {
+public:
+  virtual void notify() = 0;
+  virtual ~Observer() = default;
+};
+
+class Subject {
+  std::vector<Observer*> observers; // interested in everything
+  std::unordered_map<std::string, std::vector<Observer*>> keyed; // interested in one key
+public:
+  // Attach an observer one way or the other: attached both with and without
+  //   a key, it is notified twice.
+  void attach(Observer* ob) { observers.push_back(ob); }
+  void attach(Observer* ob, const std::string& key) { keyed[key].push_back(ob); }
+  // Detaches ob completely, with or without keys. O(all observers)
+  void detach(Observer* ob) {
+    std::erase(observers, ob);
+    for (auto it = keyed.begin(); it != keyed.end(); ) {
+      std::erase(it->second, ob);
+      it = it->second.empty() ? keyed.erase(it) : std::next(it);
+    }
+  }
+  // O(observers attached with this key)
+  void detach(Observer* ob, const std::string& key) {
+    auto it = keyed.find(key);
+    if (it == keyed.end()) return;
+    std::erase(it->second, ob);
+    if (it->second.empty()) keyed.erase(it);
+  }
+  void notifyObservers() { // everybody, whatever their key
+    for (auto ob : observers) ob->notify();
+    for (auto& [key, obs] : keyed) for (auto ob : obs) ob->notify();
+  }
+  void notifyObservers(const std::string& key) { // what changed is about key
+    for (auto ob : observers) ob->notify();
+    auto it = keyed.find(key);
+    if (it != keyed.end()) for (auto ob : it->second) ob->notify();
+  }
+  virtual ~Subject() = 0;
+};
+Subject::~Subject() { }
+
+// One winner per line.
+class HorseRace : public Subject {
+  std::istream& in;
+  std::string lastWinner;
+public:
+  explicit HorseRace(std::istream& in) : in{in} { }
+  bool runRace() { return static_cast<bool>(std::getline(in, lastWinner)); }
+  const std::string& getLastWinner() const { return lastWinner; }
+};
+
+class Bettor : public Observer {
+  HorseRace* hr;
+  std::string name, myHorse;
+  int wins = 0;
+public:
+  Bettor(HorseRace* hr, std::string name, std::string myHorse) :
+    hr{hr}, name{std::move(name)}, myHorse{std::move(myHorse)} { }
+  const std::string& getHorse() const { return myHorse; }
+  int getWins() const { return wins; }
+  void notify() override { // still checks: it may be attached without a key
+    if (hr->getLastWinner() == myHorse) ++wins;
+  }
+};
+
+// TestHarness
+std::ifstream in{"races.txt"};
+HorseRace hr{in};
+std::vector<std::unique_ptr<Bettor>> bettors;
+/* create the bettors */
+for (auto& b : bettors) hr.attach(b.get(), b->getHorse()); // only their horse
+while (hr.runRace()) hr.notifyObservers(hr.getLastWinner());
+
+// Benchmark: 100000 bettors on 20 horses, 1000 races, all vs. keyed.
+import <chrono>;
+import <memory>;
+import <random>;
+import <sstream>;
+int main() {
+  const int numBettors = 100'000, numHorses = 20, numRaces = 1000;
+  std::mt19937 gen{49};
+  std::string races;
+  for (int r = 0; r < numRaces; ++r) races += "Horse " + std::to_string(gen() % numHorses) + "\n";
+
+  auto run = [&](bool keyed) {
+    std::istringstream in{races};
+    HorseRace hr{in};
+    std::vector<std::unique_ptr<Bettor>> bettors;
+    for (int i = 0; i < numBettors; ++i) {
+      bettors.push_back(std::make_unique<Bettor>(&hr, "Bettor " + std::to_string(i), 
+                                                 "Horse " + std::to_string(i % numHorses)));
+      if (keyed) hr.attach(bettors.back().get(), bettors.back()->getHorse());
+      else hr.attach(bettors.back().get());
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    while (hr.runRace()) {
+      if (keyed) hr.notifyObservers(hr.getLastWinner());
+      else hr.notifyObservers();
+    }
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    long wins = 0;
+    for (auto& b : bettors) wins += b->getWins();
+    std::cout << (keyed ? "keyed: " : "all:   ") << s * 1e6 / numRaces << " us per race, " 
+              << wins << " wins" << std::endl;
+  };
+  run(false);
+  run(true);
+}
+// Both print the same number of wins. Keyed notifies numBettors / numHorses
+//   bettors per race instead of all of them, so it is about numHorses times faster.
+// Remember point 4: the order of notification is not guaranteed, and now
+//   it differs between keyed and unkeyed observers.
+
+
+// ********** 5. Observer Example: Notifying on Worker Threads **********
+// notifyObservers() calls every notify() on the thread that changed the state.
+//   One slow observer (say, a Bettor that writes each result to a database) 
+//   and runRace() waits for it, every race.
+// Instead, notifyObservers() can put the change on a queue and return. 
+//   Worker threads take changes off the queue and notify the observers.
+// Three things to get right:
+// -- the state travels with the change (push, point 5 in 1). By the time a 
+//    worker notifies, the race may have been run again: an observer that 
+//    called hr->getLastWinner() would see the wrong winner.
+// -- ordering: an observer must get the changes in the order they happened.
+//    Two workers taking two changes for the same observer could deliver them
+//    in either order. So each observer belongs to one worker (by a hash of
+//    its address), and each worker has its own FIFO queue: the notifications 
+//    of one observer are one thread's work, in queue order.
+// -- backpressure: the queues are bounded. When a worker falls too far
+//    behind, notifyObservers() waits for room instead of using up memory.
+// The queue itself is a plain bounded queue with a lock; any number of 
+//   threads may push (several subjects' setters) and pop.
+import <algorithm>;
+import <atomic>;
+import <condition_variable>;
+import <cstdint>;
+import <deque>;
+import <memory>;
+import <mutex>;
+import <optional>;
+import <string>;
+import <thread>;
+import <unordered_map>;
+import <utility>;
+import <vector>;
+
+template <typename T>
+class BoundedQueue {
+  std::mutex m;
+  std::condition_variable notFull, notEmpty;
+  std::deque<T> items;
+  size_t capacity;
+  bool closed = false;
+public:
+  explicit BoundedQueue(size_t capacity) : capacity{capacity} { }
+  // Waits while the queue is full. False if the queue was closed.
+  bool push(T item) {
+    std::unique_lock lock{m};
+    notFull.wait(lock, [&] { return items.size() < capacity || closed; });
+    if (closed) return false;
+    items.push_back(std::move(item));
+    notEmpty.notify_one();
+    return true;
+  }
+  // Waits while the queue is empty. Empty once the queue is closed and drained.
+  std::optional<T> pop() {
+    std::unique_lock lock{m};
+    notEmpty.wait(lock, [&] { return !items.empty() || closed; });
+    if (items.empty()) return std::nullopt;
+    T item = std::move(items.front());
+    items.pop_front();
+    notFull.notify_one();
+    return item;
+  }
+  void close() {
+    std::lock_guard lock{m};
+    closed = true;
+    notFull.notify_all();
+    notEmpty.notify_all();
+  }
+};
+
+template <typename Event>
+class EventObserver {
+public:
+  virtual void notify(const Event& e) = 0; // e is the state at the change
+  virtual ~EventObserver() = default;
+};
+
+// True on a thread while it runs notify() for any AsyncSubject.
+inline thread_local bool insideNotify = false;
+
+// Keyed subscriptions as in 4. With 0 workers, notifyObservers() notifies 
+//   on the calling thread, like Subject.
+template <typename Event>
+class AsyncSubject {
+  using Observer = EventObserver<Event>;
+  struct Change {
+    std::shared_ptr<const Event> event; // one copy, shared by all the workers
+    std::string key;
+    bool all;                           // for everybody, whatever their key
+  };
+  struct Worker {
+    BoundedQueue<Change> queue;
+    std::mutex deliverLock; // one change at a time (with 0 workers, several threads may notify)
+    std::mutex lock;        // guards the lists and the delivery state; never held in notify()
+    std::condition_variable delivered;
+    std::vector<Observer*> observers;
+    std::unordered_map<std::string, std::vector<Observer*>> keyed;
+    std::vector<Observer*> targets;     // copy of the lists for the change being delivered
+    std::vector<Observer*> detachedNow; // detached from inside notify() during this change
+    std::atomic<bool> anyDetachedNow = false; // detachedNow is not empty
+    std::thread::id deliverer;          // the thread delivering a change, if any
+    std::uint64_t finished = 0;         // changes delivered so far
+    std::thread thread;
+    explicit Worker(size_t capacity) : queue{capacity} { }
+  };
+  std::vector<std::unique_ptr<Worker>> workers;
+  bool async;
+
+  Worker& workerFor(Observer* ob) { // same observer, same worker
+    std::uint64_t h = reinterpret_cast<std::uintptr_t>(ob) * 0x9E3779B97F4A7C15ull;
+    return *workers[(h >> 32) % workers.size()];
+  }
+  // Copies the interested observers under the lock and notifies them without
+  //   it, so notify() may attach and detach, and attach/detach on other 
+  //   threads don't wait for slow observers.
+  static void deliver(Worker& w, const Change& c) {
+    std::lock_guard one{w.deliverLock};
+    {
+      std::lock_guard lock{w.lock};
+      w.targets = w.observers;
+      if (c.all) {
+        for (auto& [key, obs] : w.keyed) w.targets.insert(w.targets.end(), obs.begin(), obs.end());
+      } else if (auto it = w.keyed.find(c.key); it != w.keyed.end()) {
+        w.targets.insert(w.targets.end(), it->second.begin(), it->second.end());
+      }
+      w.deliverer = std::this_thread::get_id();
+    }
+    bool outer = std::exchange(insideNotify, true);
+    for (auto ob : w.targets) {
+      if (w.anyDetachedNow && skipped(w, ob)) continue; // rare: lock only then
+      ob->notify(*c.event);
+    }
+    insideNotify = outer;
+    {
+      std::lock_guard lock{w.lock};
+      w.deliverer = {};
+      w.detachedNow.clear();
+      w.anyDetachedNow = false;
+      ++w.finished;
+    }
+    w.delivered.notify_all();
+  }
+  static bool skipped(Worker& w, Observer* ob) {
+    std::lock_guard lock{w.lock};
+    return std::ranges::find(w.detachedNow, ob) != w.detachedNow.end();
+  }
+  // Called by detach with w.lock held, after removing ob from the lists: 
+  //   a change being delivered may still have ob in its copy.
+  static void settle(Worker& w, std::unique_lock<std::mutex>& lock, Observer* ob) {
+    if (w.deliverer == std::thread::id{}) return; // nothing being delivered
+    if (insideNotify) { // from inside some notify(): skip ob, don't wait.
+      // Waiting here could deadlock: two workers each detaching an observer
+      //   of the other would wait for each other forever.
+      w.detachedNow.push_back(ob);
+      w.anyDetachedNow = true;
+      return;
+    }
+    std::uint64_t current = w.finished + 1; // wait for that change to finish
+    w.delivered.wait(lock, [&] { return w.finished >= current; });
+  }
+  void enqueue(Change c) {
+    if (!async) { deliver(*workers[0], c); return; }
+    for (auto& w : workers) w->queue.push(c); // each worker picks out its observers
+  }
+
+public:
+  AsyncSubject(unsigned numWorkers, size_t queueCapacity = 1024) : async{numWorkers > 0} {
+    for (unsigned i = 0; i < std::max(numWorkers, 1u); ++i) {
+      workers.push_back(std::make_unique<Worker>(queueCapacity));
+    }
+    if (!async) return;
+    for (auto& w : workers) {
+      w->thread = std::thread{[&w = *w] { while (auto c = w.queue.pop()) deliver(w, *c); }};
+    }
+  }
+  // Delivers what is already queued, then stops the workers.
+  virtual ~AsyncSubject() {
+    for (auto& w : workers) w->queue.close();
+    for (auto& w : workers) if (w->thread.joinable()) w->thread.join();
+  }
+  AsyncSubject(const AsyncSubject&) = delete;
+  AsyncSubject& operator=(const AsyncSubject&) = delete;
+
+  // Takes effect from the next change on.
+  void attach(Observer* ob) {
+    Worker& w = workerFor(ob);
+    std::lock_guard lock{w.lock};
+    w.observers.push_back(ob);
+  }
+  void attach(Observer* ob, const std::string& key) {
+    Worker& w = workerFor(ob);
+    std::lock_guard lock{w.lock};
+    w.keyed[key].push_back(ob);
+  }
+  // Once detach returns, ob is not being notified and will not be:
+  //   it may be destroyed. Detaches ob from every key, too.
+  // Called from inside a notify(), detach does not wait: ob gets no more
+  //   notifications, but it may be in the middle of one on another worker 
+  //   (or, if it detaches itself, in this one). Don't destroy it there.
+  void detach(Observer* ob) {
+    Worker& w = workerFor(ob);
+    std::unique_lock lock{w.lock};
+    std::erase(w.observers, ob);
+    for (auto it = w.keyed.begin(); it != w.keyed.end(); ) {
+      std::erase(it->second, ob);
+      it = it->second.empty() ? w.keyed.erase(it) : std::next(it);
+    }
+    settle(w, lock, ob);
+  }
+  void detach(Observer* ob, const std::string& key) {
+    Worker& w = workerFor(ob);
+    std::unique_lock lock{w.lock};
+    auto it = w.keyed.find(key);
+    if (it == w.keyed.end()) return;
+    std::erase(it->second, ob);
+    if (it->second.empty()) w.keyed.erase(it);
+    settle(w, lock, ob);
+  }
+
+  void notifyObservers(Event e) { 
+    enqueue({std::make_shared<const Event>(std::move(e)), {}, true});
+  }
+  void notifyObservers(const std::string& key, Event e) {
+    enqueue({std::make_shared<const Event>(std::move(e)), key, false});
+  }
+};
+
+// The HorseRace, pushing each result:
+struct RaceResult {
+  int race;
+  std::string winner;
+};
+class HorseRace : public AsyncSubject<RaceResult> {
+  std::istream& in;
+  int races = 0;
+public:
+  HorseRace(std::istream& in, unsigned numWorkers) : AsyncSubject{numWorkers}, in{in} { }
+  bool runRace() {
+    std::string winner;
+    if (!std::getline(in, winner)) return false;
+    notifyObservers(winner, {++races, winner});
+    return true;
+  }
+};
+// Important: 
+// -- notify() now runs on a worker thread. Observers on different workers
+//    run at the same time, so anything they share needs a lock or an atomic.
+// -- a notification may arrive after runRace() has returned, even after 
+//    the next race. Destroying the subject delivers everything queued.
+// -- per-observer order holds; the order between observers does not (point 4).
+// -- an observer may detach itself (or attach others) inside notify(), as 
+//    in the sequence of calls in 1.
+
+// Benchmark: 10000 bettors on 20 horses, 2000 races, plus one slow observer
+//   (it sleeps 100us per race, like a write to a database), for 0 
+//   (synchronous) to 4 workers. 
+// Latency: from the change to notify(). Throughput: races per second 
+//   that runRace() gets through, and until everything is delivered.
+import <algorithm>;
+import <atomic>;
+import <chrono>;
+import <iostream>;
+import <random>;
+import <sstream>;
+using Clock = std::chrono::steady_clock;
+struct Timed {
+  int race;
+  std::string winner;
+  Clock::time_point sent = Clock::now();
+};
+
+class Bettor : public EventObserver<Timed> {
+  std::string myHorse;
+  int lastRace = 0;
+public:
+  int wins = 0, outOfOrder = 0;
+  double totalLatency = 0, maxLatency = 0; // seconds
+  explicit Bettor(std::string horse) : myHorse{std::move(horse)} { }
+  const std::string& getHorse() const { return myHorse; }
+  void notify(const Timed& e) override {
+    double lat = std::chrono::duration<double>(Clock::now() - e.sent).count();
+    totalLatency += lat;
+    maxLatency = std::max(maxLatency, lat);
+    if (e.race <= lastRace) ++outOfOrder;
+    lastRace = e.race;
+    if (e.winner == myHorse) ++wins;
+  }
+};
+class SlowLogger : public EventObserver<Timed> {
+public:
+  void notify(const Timed&) override { std::this_thread::sleep_for(std::chrono::microseconds{100}); }
+};
+
+int main(int argc, char* argv[]) {
+  const int numBettors = 10'000, numHorses = 20, numRaces = 2000;
+  const size_t capacity = argc > 1 ? std::stoul(argv[1]) : 1024;
+  std::mt19937 gen{50};
+  std::vector<std::string> winners;
+  for (int r = 0; r < numRaces; ++r) winners.push_back("Horse " + std::to_string(gen() % numHorses));
+
+  for (unsigned numWorkers : {0u, 1u, 2u, 4u}) {
+    std::vector<std::unique_ptr<Bettor>> bettors;
+    for (int i = 0; i < numBettors; ++i) bettors.push_back(std::make_unique<Bettor>("Horse " + std::to_string(i % numHorses)));
+    SlowLogger logger;
+    auto t0 = Clock::now();
+    double produced;
+    {
+      AsyncSubject<Timed> subject{numWorkers, capacity};
+      subject.attach(&logger);
+      for (auto& b : bettors) subject.attach(b.get(), b->getHorse());
+      t0 = Clock::now();
+      for (int r = 0; r < numRaces; ++r) subject.notifyObservers(winners[r], {r + 1, winners[r]});
+      produced = std::chrono::duration<double>(Clock::now() - t0).count();
+    } // waits for the workers to finish
+    double delivered = std::chrono::duration<double>(Clock::now() - t0).count();
+    double total = 0, worst = 0;
+    long wins = 0, outOfOrder = 0; // keyed: every notification a bettor gets is a win
+    for (auto& b : bettors) {
+      total += b->totalLatency;
+      worst = std::max(worst, b->maxLatency);
+      wins += b->wins;
+      outOfOrder += b->outOfOrder;
+    }
+    std::cout << numWorkers << " workers: runRace " << numRaces / produced << " races/s, delivered "
+              << numRaces / delivered << " races/s, latency mean " << total / wins * 1e6 
+              << "us max " << worst * 1e6 << "us, " << wins << " wins, " << outOfOrder << " out of order" << std::endl;
+  }
+}
+// With 0 workers every race waits for the logger: about 10000 races/s at best.
+// With workers, runRace() runs ahead of the logger until its queue is full
+//   (capacity races; pass a capacity as argv[1]), then goes at the logger's
+//   pace: backpressure. Bettors that share a worker with the logger wait 
+//   behind it; the others do not. More workers: fewer bettors stuck behind it.
+// Latency is the price: a notification waits in the queue, and with a full
+//   queue it waits for capacity races to be delivered before it.
+// Without a slow observer, synchronous notify is faster: a queue push and 
+//   a thread wakeup cost more than a short notify(). Use workers when
+//   observers are slow or block, not by default.
@@ -299,3 +299,184 @@ std::unique_ptr<C> cp2 = cp; // calling cctor to copy cp
 // 2. raw pointer : indicates non-ownership since the raw pointer is consider
 // not to own the resources it points at, you should not delete it 
 // 3. moving a unique_ptr (into or out of a function) means transfer ownership
+
+
+
+// ********** 7. Example: Fast Roster Loading **********
+// Loading a roster the usual way:
+Student s;
+while (cin >> s.assns >> s.mt >> s.final) { /*...*/ } // or with cin.exceptions
+// For a large roster, startup is mostly spent inside >> (locale, whitespace,
+//   state checks per number), and bad input handled by exceptions is slow
+//   when there is a lot of it.
+
+// Faster loader:
+// 1. read the whole text file at once, parse it with std::from_chars,
+//    check each mark is 0..100. Errors are returned as values, not thrown:
+//    bad input is expected here, not exceptional.
+// 2. save the parsed records in a binary cache file next to it (roster.txt.bin).
+// 3. next time, if the cache was built from this very text (same size and
+//    modification time), don't parse at all:
+//    memory-map the cache. The OS makes the file's bytes appear in our 
+//    address space and only reads pages when we touch them, so "loading"
+//    takes about the same time no matter how big the roster is.
+// The mapping is a resource, so it gets an RAII owner (see 6.): the dtor unmaps.
+// The cache is only a shortcut: if it cannot be written or mapped (read-only
+//   directory, full disk), the roster keeps the parsed records in memory.
+import <algorithm>;
+import <charconv>;
+import <cstdint>;
+import <cstring>;
+import <filesystem>;
+import <fstream>;
+import <string>;
+import <utility>;
+import <vector>;
+#include <fcntl.h>    // POSIX: open
+#include <sys/mman.h> // POSIX: mmap, munmap
+#include <sys/stat.h> // POSIX: fstat
+#include <unistd.h>   // POSIX: close
+
+struct RosterRecord { int32_t assns, mt, final; }; // fixed size on disk
+
+struct CacheHeader {
+  char magic[8];          // "ROSTER1", so we don't map some random file
+  uint64_t count;         // number of records after the header
+  uint64_t sourceSize;    // size and modification time of the text file
+  int64_t sourceTime;     //   the cache was built from
+};
+
+enum class LoadError { None, CannotOpen, BadRecord, OutOfRange, BadCache };
+
+class Roster {
+  void* map = nullptr;  // the mapped cache file, or nullptr
+  size_t mapSize = 0;
+  std::vector<RosterRecord> owned; // the parsed records, when there is no mapping
+  const RosterRecord* recs = nullptr; // into the mapping or into owned
+  size_t n = 0;
+
+  LoadError mapCache(const std::string& cachePath, const CacheHeader& expect);
+  static LoadError parse(const std::string& text, std::vector<RosterRecord>& out, size_t& badLine);
+
+public:
+  Roster() = default;
+  ~Roster() { if (map) munmap(map, mapSize); }
+  Roster(const Roster&) = delete;            // only one owner of the mapping
+  Roster& operator=(const Roster&) = delete;
+  Roster(Roster&& other) noexcept : map{std::exchange(other.map, nullptr)}, mapSize{other.mapSize}, 
+    owned{std::move(other.owned)}, // keeps its buffer, so recs stays valid
+    recs{std::exchange(other.recs, nullptr)}, n{std::exchange(other.n, 0)} { }
+
+  // Loads path, using (or creating) path + ".bin".
+  // On BadRecord / OutOfRange, badLine is the 1-based line number.
+  LoadError load(const std::string& path, size_t& badLine);
+
+  size_t size() const { return n; }
+  Student operator[](size_t i) const { return Student{recs[i].assns, recs[i].mt, recs[i].final}; }
+};
+
+LoadError Roster::parse(const std::string& text, std::vector<RosterRecord>& out, size_t& badLine) {
+  const char* p = text.data();
+  const char* end = p + text.size();
+  for (size_t line = 1; p < end; ++line) {
+    const char* eol = std::find(p, end, '\n');
+    while (p < eol && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+    if (p == eol) { p = eol + 1; continue; } // ignore blank lines
+    int32_t v[3];
+    for (int32_t& x : v) {
+      while (p < eol && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+      auto [next, ec] = std::from_chars(p, eol, x);
+      if (ec != std::errc{}) { badLine = line; return LoadError::BadRecord; }
+      if (x < 0 || x > 100) { badLine = line; return LoadError::OutOfRange; }
+      p = next;
+    }
+    while (p < eol && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+    if (p != eol) { badLine = line; return LoadError::BadRecord; } // "60 70 80 99", "60 70 80x"
+    out.push_back({v[0], v[1], v[2]});
+    p = eol + 1;
+  }
+  return LoadError::None;
+}
+
+LoadError Roster::mapCache(const std::string& cachePath, const CacheHeader& expect) {
+  int fd = open(cachePath.c_str(), O_RDONLY);
+  if (fd < 0) return LoadError::CannotOpen;
+  struct stat st; // size of the open file: no second lookup by name, no exceptions
+  if (fstat(fd, &st) != 0) { close(fd); return LoadError::BadCache; }
+  size_t size = st.st_size;
+  void* m = size >= sizeof(CacheHeader) ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+  close(fd); // the mapping stays valid after the file descriptor is closed
+  if (m == MAP_FAILED) return LoadError::BadCache;
+  CacheHeader h;
+  std::memcpy(&h, m, sizeof h);
+  if (std::memcmp(h.magic, expect.magic, sizeof h.magic) != 0 || h.sourceSize != expect.sourceSize 
+      || h.sourceTime != expect.sourceTime || size != sizeof h + h.count * sizeof(RosterRecord)) {
+    munmap(m, size); // stale or not ours
+    return LoadError::BadCache;
+  }
+  if (map) munmap(map, mapSize);
+  map = m;
+  mapSize = size;
+  recs = reinterpret_cast<const RosterRecord*>(static_cast<const char*>(m) + sizeof h);
+  n = h.count;
+  return LoadError::None;
+}
+
+LoadError Roster::load(const std::string& path, size_t& badLine) {
+  std::error_code ec; // the non-throwing overloads of filesystem functions
+  CacheHeader h{"ROSTER1", 0, std::filesystem::file_size(path, ec), 0};
+  if (ec) return LoadError::CannotOpen;
+  h.sourceTime = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+  std::string cachePath = path + ".bin";
+  if (mapCache(cachePath, h) == LoadError::None) return LoadError::None; // fast path
+
+  // slow path: parse the text once
+  std::ifstream in{path, std::ios::binary};
+  if (!in) return LoadError::CannotOpen;
+  std::string text(h.sourceSize, '\0');
+  in.read(text.data(), text.size());
+  std::vector<RosterRecord> parsed;
+  parsed.reserve(text.size() / 9); // "100 90 80\n" is about 10 chars
+  if (LoadError e = parse(text, parsed, badLine); e != LoadError::None) return e;
+
+  // write to a temporary name, then rename: a crash halfway never leaves 
+  //   a half-written roster.txt.bin that looks valid
+  h.count = parsed.size();
+  std::string tmp = cachePath + ".tmp";
+  bool written;
+  {
+    std::ofstream out{tmp, std::ios::binary};
+    out.write(reinterpret_cast<const char*>(&h), sizeof h);
+    out.write(reinterpret_cast<const char*>(parsed.data()), parsed.size() * sizeof(RosterRecord));
+    out.close(); // flushes; a full disk shows up here
+    written = static_cast<bool>(out);
+  }
+  if (written) std::filesystem::rename(tmp, cachePath, ec);
+  if (!written || ec) std::filesystem::remove(tmp, ec);
+  else if (mapCache(cachePath, h) == LoadError::None) return LoadError::None;
+
+  // no cache this time: serve the records we just parsed
+  if (map) munmap(map, mapSize);
+  map = nullptr;
+  owned = std::move(parsed);
+  recs = owned.data();
+  n = owned.size();
+  return LoadError::None;
+}
+
+// client
+int main() {
+  Roster r;
+  size_t line = 0;
+  switch (r.load("roster.txt", line)) {
+    case LoadError::None: break;
+    case LoadError::CannotOpen: std::cerr << "cannot read roster.txt\n"; return 1;
+    case LoadError::BadRecord:  std::cerr << "roster.txt:" << line << ": expected 3 marks\n"; return 1;
+    case LoadError::OutOfRange: std::cerr << "roster.txt:" << line << ": mark not in 0..100\n"; return 1;
+    case LoadError::BadCache:   std::cerr << "cannot use roster.txt.bin\n"; return 1;
+  }
+  std::cout << r.size() << " students, first grade " << r[0].grade() << '\n';
+}
+// First run: parses and writes roster.txt.bin. Later runs: just mmap.
+// Note: the cache stores ints in this machine's byte order; it is a cache,
+//   not a file format to copy to other machines. Delete it any time.
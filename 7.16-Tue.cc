@@ -244,3 +244,893 @@ public:
 // but pure virtual dtors are a special case.
 // The sub-class dtor will call the base class dtor, 
 // so it must exist in the program.
+
+
+// ********** A Collection that Groups Objects by Type **********
+// Recall the catalog loop from 6.27:
+Book* myBooks[20];
+for (int i = 0; i < 20; ++i) cout << myBooks[i]->isHeavy() << endl;
+// Each Book, Text and Comic is a separate heap object, and each call goes
+//   through the vtable. For millions of books both hurt (cache misses, 
+//   mispredicted indirect jumps).
+// In 6.27 we fixed the same problem for Students with StudentBuckets: one
+//   vector per concrete type. Here is the general version, as a template:
+//   PolyCollection<Base, T1, T2, ...> has one vector (segment) per Ti.
+// Within a segment the type is known exactly. If the Ti are `final`, 
+//   the compiler calls Ti::isHeavy() directly, no vtable.
+// With the hierarchy above, the concrete classes are leaves (Book, Text, Comic)
+//   and can all be final; AbstractBook is the "Book&" generic code uses.
+import <string>;
+import <tuple>;
+import <type_traits>;
+import <utility>;
+import <vector>;
+
+class AbstractBook {
+  std::string title, author;
+protected:
+  int length;
+public:
+  AbstractBook(std::string title, std::string author, int length) :
+    title{std::move(title)}, author{std::move(author)}, length{length} { }
+  virtual ~AbstractBook() = 0;
+  virtual bool isHeavy() const = 0;
+  virtual std::string identify() const = 0;
+  const std::string& getTitle() const { return title; }
+  const std::string& getAuthor() const { return author; }
+  int getLength() const { return length; }
+  void setTitle(std::string t) { title = std::move(t); }
+  void setAuthor(std::string a) { author = std::move(a); }
+};
+AbstractBook::~AbstractBook() { } // pure virtual dtor still needs a body
+
+class Book final : public AbstractBook {
+public:
+  using AbstractBook::AbstractBook;
+  bool isHeavy() const override { return length > 200; }
+  std::string identify() const override { return "Book"; }
+};
+class Text final : public AbstractBook {
+  std::string topic;
+public:
+  Text(std::string title, std::string author, int length, std::string topic) :
+    AbstractBook{std::move(title), std::move(author), length}, topic{std::move(topic)} { }
+  bool isHeavy() const override { return length > 500; }
+  std::string identify() const override { return "Text"; }
+  const std::string& getTopic() const { return topic; }
+};
+class Comic final : public AbstractBook {
+  std::string hero;
+public:
+  Comic(std::string title, std::string author, int length, std::string hero) :
+    AbstractBook{std::move(title), std::move(author), length}, hero{std::move(hero)} { }
+  bool isHeavy() const override { return length > 30; }
+  std::string identify() const override { return "Comic"; }
+  const std::string& getHero() const { return hero; }
+};
+
+template <typename Base, typename... Ts> class PolyCollection {
+  static_assert((std::is_base_of_v<Base, Ts> && ...), "every Ti must derive from Base");
+  std::tuple<std::vector<Ts>...> segments; // one vector per type
+
+public:
+  // constructs a T in place at the end of T's segment
+  template <typename T, typename... Args> T& emplace(Args&&... args) {
+    return std::get<std::vector<T>>(segments).emplace_back(std::forward<Args>(args)...);
+  }
+  template <typename T> std::vector<T>& segment() { return std::get<std::vector<T>>(segments); }
+
+  size_t size() const {
+    return std::apply([](auto&... seg) { return (seg.size() + ... + 0); }, segments);
+  }
+
+  // f(x) for every object, segment by segment, where x has its exact type 
+  //   (Book&, then Text&, then Comic&). f is usually a generic lambda 
+  //   (auto& parameter), specialized once per segment.
+  template <typename Fn> void forEach(Fn f) {
+    std::apply([&f](auto&... seg) { (..., [&f](auto& s) { for (auto& x : s) f(x); }(seg)); }, segments);
+  }
+
+  // f(b) with b a Base&, for generic code that only knows the interface.
+  //   Calls through b are virtual as usual.
+  template <typename Fn> void forEachBase(Fn f) {
+    forEach([&f](auto& x) { f(static_cast<Base&>(x)); });
+  }
+};
+// Note: the order is by type, not by insertion.
+// Note: emplace may reallocate a segment, which invalidates references into 
+//   it (same rule as vector).
+
+// client
+using BookCollection = PolyCollection<AbstractBook, Book, Text, Comic>;
+BookCollection books;
+books.emplace<Text>("Algorithms", "CLRS", 1300, "CS");
+books.emplace<Comic>("Spider-Man", "Stan Lee", 32, "Spider-Man");
+books.emplace<Book>("A small book", "Papa Smurf", 50);
+int heavy = 0;
+books.forEach([&heavy](const auto& b) { heavy += b.isHeavy(); }); // direct calls
+void printAll(const AbstractBook& b) { cout << b.identify() << ": " << b.getTitle() << endl; }
+books.forEachBase(printAll); // generic code, virtual calls
+
+// Benchmark: Book* array (one heap object each, shuffled) vs. segments
+import <algorithm>;
+import <chrono>;
+import <iostream>;
+import <memory>;
+import <random>;
+int main() {
+  const int n = 3'000'000;
+  std::mt19937 gen{246};
+  std::vector<std::unique_ptr<AbstractBook>> owned;
+  BookCollection cat;
+  for (int i = 0; i < n; ++i) {
+    int len = gen() % 1000;
+    switch (gen() % 3) {
+      case 0: owned.push_back(std::make_unique<Book>("b", "a", len)); cat.emplace<Book>("b", "a", len); break;
+      case 1: owned.push_back(std::make_unique<Text>("t", "a", len, "CS")); cat.emplace<Text>("t", "a", len, "CS"); break;
+      case 2: owned.push_back(std::make_unique<Comic>("c", "a", len, "X")); cat.emplace<Comic>("c", "a", len, "X"); break;
+    }
+  }
+  std::vector<AbstractBook*> myBooks;
+  for (auto& p : owned) myBooks.push_back(p.get());
+  std::shuffle(myBooks.begin(), myBooks.end(), gen); // catalog order != allocation order
+
+  using Clock = std::chrono::steady_clock;
+  auto ms = [](auto d) { return std::chrono::duration<double, std::milli>(d).count(); };
+  auto t0 = Clock::now();
+  int heavy1 = 0;
+  for (AbstractBook* b : myBooks) heavy1 += b->isHeavy();
+  double tPtrs = ms(Clock::now() - t0);
+  t0 = Clock::now();
+  int heavy2 = 0;
+  cat.forEach([&heavy2](const auto& b) { heavy2 += b.isHeavy(); });
+  double tSegs = ms(Clock::now() - t0);
+  int heavy3 = 0;
+  cat.forEachBase([&heavy3](const AbstractBook& b) { heavy3 += b.isHeavy(); });
+
+  std::cout << "Book* loop: " << tPtrs << "ms, segments: " << tSegs << "ms, " 
+            << (heavy1 == heavy2 && heavy2 == heavy3 ? "same" : "DIFFERENT") << " count " << heavy1 << std::endl;
+}
+
+
+// ********** A Book Catalog with Indexes **********
+// Finding a book by title, or listing all books by an author, by scanning a
+//   vector of Book* and comparing strings is O(n) per question.
+// A Catalog owns its books (unique_ptr, see above) and keeps two indexes:
+// -- title -> book:  a hash map (unordered_multimap), O(1) expected lookup
+// -- author -> book: kept sorted (std::set), so "all authors starting with
+//    'Kn'" or "authors from 'A' to 'C'" are a lower_bound plus a short walk,
+//    O(log n + number of answers)
+// The index keys are string_views pointing at the strings inside the books 
+//   themselves, so titles and authors are not stored twice. This is safe 
+//   because each book is a separate heap object that never moves; and before
+//   a book's title/author changes, its index entries are taken out.
+import <algorithm>;
+import <cstdint>;
+import <memory>;
+import <set>;
+import <stdexcept>;
+import <string>;
+import <string_view>;
+import <unordered_map>;
+import <utility>;
+import <vector>;
+
+class Catalog {
+public:
+  using Id = uint32_t; // stays the same for a book until it is removed
+
+private:
+  std::vector<std::unique_ptr<AbstractBook>> books; // books[id], nullptr if removed
+  std::vector<Id> freeIds;                           // removed ids, reused by insert
+  std::unordered_multimap<std::string_view, Id> byTitle;
+  std::set<std::pair<std::string_view, Id>> byAuthor;  // sorted by author, then id
+
+  void index(Id id) {
+    byTitle.emplace(books[id]->getTitle(), id);
+    byAuthor.emplace(books[id]->getAuthor(), id);
+  }
+  // Throws std::out_of_range for an id that was never given out or was removed.
+  void check(Id id) const {
+    if (id >= books.size() || !books[id]) throw std::out_of_range{"Catalog: no book with this id"};
+  }
+  void unindex(Id id) {
+    auto [first, last] = byTitle.equal_range(books[id]->getTitle());
+    for (auto it = first; it != last; ++it) {
+      if (it->second == id) { byTitle.erase(it); break; }
+    }
+    byAuthor.erase({books[id]->getAuthor(), id});
+  }
+
+public:
+  Id insert(std::unique_ptr<AbstractBook> b) {
+    Id id;
+    if (freeIds.empty()) {
+      id = books.size();
+      books.push_back(std::move(b));
+    } else {
+      id = freeIds.back();
+      freeIds.pop_back();
+      books[id] = std::move(b);
+    }
+    index(id);
+    return id;
+  }
+
+  // Appends many books at once: at most one reallocation of books and one 
+  //   rehash of byTitle for the whole batch. Grows geometrically, so many
+  //   small batches still cost O(n) in total, like push_back.
+  //   Returns the id of each book, in order.
+  std::vector<Id> insertBatch(std::vector<std::unique_ptr<AbstractBook>> batch) {
+    size_t appended = batch.size() > freeIds.size() ? batch.size() - freeIds.size() : 0;
+    size_t neededBooks = books.size() + appended;
+    if (neededBooks > books.capacity()) books.reserve(std::max(2 * books.capacity(), neededBooks));
+    size_t neededTitles = byTitle.size() + batch.size();
+    if (neededTitles > byTitle.bucket_count() * byTitle.max_load_factor()) {
+      byTitle.reserve(std::max(2 * byTitle.size(), neededTitles));
+    }
+    std::vector<Id> ids;
+    ids.reserve(batch.size());
+    for (auto& b : batch) ids.push_back(insert(std::move(b))); // moves the pointer only
+    return ids;
+  }
+
+  void remove(Id id) {
+    check(id); // removing twice would also put id on freeIds twice
+    unindex(id); // while the strings the keys point at still exist
+    books[id].reset();
+    freeIds.push_back(id);
+  }
+
+  // All changes go through here, so the indexes can't get out of date:
+  //   catalog.update(id, [](AbstractBook& b) { b.setAuthor("Knuth"); });
+  template <typename Fn> void update(Id id, Fn f) {
+    check(id);
+    unindex(id);
+    try {
+      f(*books[id]);
+    } catch (...) { // f may have changed the book halfway: index what it is now
+      index(id);
+      throw;
+    }
+    index(id);
+  }
+
+  const AbstractBook& operator[](Id id) const { check(id); return *books[id]; }
+  size_t size() const { return books.size() - freeIds.size(); }
+
+  // every book with exactly this title
+  std::vector<Id> findTitle(std::string_view title) const {
+    std::vector<Id> result;
+    auto [first, last] = byTitle.equal_range(title);
+    for (auto it = first; it != last; ++it) result.push_back(it->second);
+    return result;
+  }
+
+  // books by exactly this author: f(id)
+  template <typename Fn> void forAuthor(std::string_view author, Fn f) const {
+    for (auto it = byAuthor.lower_bound({author, 0}); it != byAuthor.end() && it->first == author; ++it) {
+      f(it->second);
+    }
+  }
+  // books whose author is in [from, to), in author order: f(id)
+  template <typename Fn> void forAuthorsInRange(std::string_view from, std::string_view to, Fn f) const {
+    for (auto it = byAuthor.lower_bound({from, 0}); it != byAuthor.end() && it->first < to; ++it) {
+      f(it->second);
+    }
+  }
+  // books whose author starts with prefix, in author order: f(id)
+  template <typename Fn> void forAuthorPrefix(std::string_view prefix, Fn f) const {
+    for (auto it = byAuthor.lower_bound({prefix, 0}); 
+         it != byAuthor.end() && it->first.starts_with(prefix); ++it) {
+      f(it->second);
+    }
+  }
+};
+// Note: Catalog is not copyable (unique_ptrs), and copying it would be wrong
+//   anyway: the string_views would point into the other catalog's books.
+
+// Benchmark: lookups vs. scanning, at 10^7 books (about 2GB; pass a smaller n to try)
+import <chrono>;
+import <iostream>;
+import <random>;
+int main(int argc, char* argv[]) {
+  size_t n = argc > 1 ? std::stoull(argv[1]) : 10'000'000;
+  std::mt19937 gen{246};
+  Catalog cat;
+  std::vector<const AbstractBook*> scan; // the old way, for comparison
+  for (size_t i = 0; i < n; ++i) {
+    std::string title = "Title " + std::to_string(i);
+    std::string author = "Author " + std::to_string(gen() % (n / 20 + 1)); // ~20 books each
+    Catalog::Id id = i % 2 ? cat.insert(std::make_unique<Book>(title, author, 100))
+                           : cat.insert(std::make_unique<Text>(title, author, 600, "CS"));
+    scan.push_back(&cat[id]);
+  }
+
+  using Clock = std::chrono::steady_clock;
+  auto us = [](auto d) { return std::chrono::duration<double, std::micro>(d).count(); };
+  std::string wanted = "Title " + std::to_string(n / 2);
+  std::string author = "Author 42";
+
+  auto t0 = Clock::now();
+  size_t found = cat.findTitle(wanted).size();
+  double tHash = us(Clock::now() - t0);
+  t0 = Clock::now();
+  size_t scanned = 0;
+  for (const AbstractBook* b : scan) scanned += b->getTitle() == wanted;
+  double tScanTitle = us(Clock::now() - t0);
+
+  t0 = Clock::now();
+  size_t byAuthor = 0;
+  cat.forAuthor(author, [&byAuthor](Catalog::Id) { ++byAuthor; });
+  double tOrdered = us(Clock::now() - t0);
+  t0 = Clock::now();
+  size_t scannedAuthor = 0;
+  for (const AbstractBook* b : scan) scannedAuthor += b->getAuthor() == author;
+  double tScanAuthor = us(Clock::now() - t0);
+
+  size_t prefixed = 0; // "Author 42", "Author 420", "Author 4213", ...
+  cat.forAuthorPrefix(author, [&prefixed](Catalog::Id) { ++prefixed; });
+
+  // keep the indexes honest through remove and update
+  Catalog::Id victim = cat.findTitle(wanted).front();
+  cat.update(victim, [](AbstractBook& b) { b.setTitle("Renamed"); });
+  bool ok = cat.findTitle(wanted).empty() && cat.findTitle("Renamed").size() == 1;
+  cat.remove(victim);
+  ok = ok && cat.findTitle("Renamed").empty() && cat.size() == n - 1;
+
+  std::cout << "title:  hash " << tHash << "us, scan " << tScanTitle << "us (" << found << "/" << scanned << ")\n"
+            << "author: ordered " << tOrdered << "us, scan " << tScanAuthor << "us (" 
+            << byAuthor << "/" << scannedAuthor << "), " << prefixed << " with that prefix\n"
+            << (ok ? "indexes consistent" : "INDEXES BROKEN") << std::endl;
+}
+
+
+// ********** Searching Words: an Inverted Index **********
+// "Which books mention 'dragon' and 'moon'?" Scanning every title, topic and
+//   hero with a substring search is O(total text) per question.
+// An inverted index turns it around: for every word, the sorted list of 
+//   books that contain it (its "posting list"):
+//   "dragon" -> 3, 17, 4211, ...
+//   "moon"   -> 17, 950, 4211, ...
+// A query with several words = intersect their lists: 17, 4211.
+// -- lists are sorted, so they are stored as differences (gaps) between
+//    neighbours, and small gaps take 1 byte instead of 4 (varint encoding)
+// -- intersection compares 4 numbers against 4 numbers at a time with SSE2
+// -- adding a book only appends to the end of lists: each added book gets
+//    the next document number, which is always the largest so far
+import <algorithm>;
+import <cctype>;
+import <cstdint>;
+import <string>;
+import <string_view>;
+import <unordered_map>;
+import <vector>;
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Sorted a and b -> the numbers in both, appended to out
+void intersect(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, std::vector<uint32_t>& out) {
+  size_t i = 0, j = 0;
+#ifdef __SSE2__
+  // compare a[i..i+3] with every one of b[j..j+3] by rotating b's 4 lanes
+  while (i + 4 <= a.size() && j + 4 <= b.size()) {
+    __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&a[i]));
+    __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&b[j]));
+    __m128i eq = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi32(va, vb), _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x39))),
+      _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x4E)), 
+                   _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x93))));
+    int mask = _mm_movemask_ps(_mm_castsi128_ps(eq)); // one bit per lane of a
+    for (int k = 0; k < 4; ++k) {
+      if (mask & (1 << k)) out.push_back(a[i + k]);
+    }
+    // move past whichever block ends first (both, if they end together)
+    uint32_t lastA = a[i + 3], lastB = b[j + 3];
+    if (lastA <= lastB) i += 4;
+    if (lastB <= lastA) j += 4;
+  }
+#endif
+  while (i < a.size() && j < b.size()) { // the rest, one at a time
+    if (a[i] < b[j]) ++i;
+    else if (b[j] < a[i]) ++j;
+    else { out.push_back(a[i]); ++i; ++j; }
+  }
+}
+// Why no duplicates: a and b have no repeats, so an a-value matches at most
+//   once, and a block of a is only compared again with a new block of b if
+//   its last value is bigger than everything in the old b block.
+
+class TextIndex {
+  struct Postings {
+    std::vector<uint8_t> bytes; // gaps, 7 bits per byte, high bit = "more bytes follow"
+    uint32_t last = 0;          // last document number, to compute the next gap
+    uint32_t count = 0;
+
+    void append(uint32_t doc) {
+      uint32_t gap = count == 0 ? doc : doc - last;
+      while (gap >= 0x80) { bytes.push_back((gap & 0x7F) | 0x80); gap >>= 7; }
+      bytes.push_back(gap);
+      last = doc;
+      ++count;
+    }
+    std::vector<uint32_t> decode() const {
+      std::vector<uint32_t> docs;
+      docs.reserve(count);
+      uint32_t doc = 0, gap = 0;
+      int shift = 0;
+      for (uint8_t b : bytes) {
+        gap |= uint32_t{b & 0x7Fu} << shift;
+        if (b & 0x80) { shift += 7; continue; }
+        doc += gap;
+        docs.push_back(doc);
+        gap = 0;
+        shift = 0;
+      }
+      return docs;
+    }
+  };
+
+  std::unordered_map<std::string, Postings> words;
+  std::vector<Catalog::Id> docToBook; // document number -> catalog id
+  std::vector<bool> docAlive;         // false once the book is removed
+  std::unordered_map<Catalog::Id, uint32_t> bookToDoc;
+
+  // lower-case words made of letters and digits
+  template <typename Fn> static void tokenize(std::string_view text, Fn f) {
+    std::string word;
+    for (char c : text) {
+      if (std::isalnum(static_cast<unsigned char>(c))) {
+        word += std::tolower(static_cast<unsigned char>(c));
+      } else if (!word.empty()) {
+        f(word);
+        word.clear();
+      }
+    }
+    if (!word.empty()) f(word);
+  }
+
+public:
+  // Index a book's title, and its topic or hero.
+  void add(Catalog::Id id, const AbstractBook& b) {
+    remove(id); // re-adding a book (or a reused id) replaces the old entry
+    uint32_t doc = docToBook.size();
+    docToBook.push_back(id);
+    docAlive.push_back(true);
+    bookToDoc[id] = doc;
+    auto addWord = [this, doc](const std::string& w) {
+      Postings& p = words[w];
+      if (p.count == 0 || p.last != doc) p.append(doc); // a word twice in one book: once
+    };
+    tokenize(b.getTitle(), addWord);
+    if (auto t = dynamic_cast<const Text*>(&b)) tokenize(t->getTopic(), addWord);
+    if (auto c = dynamic_cast<const Comic*>(&b)) tokenize(c->getHero(), addWord);
+  }
+
+  // Old postings stay in the lists (rewriting them would be O(list));
+  //   they are filtered out of results. Rebuild the index now and then if 
+  //   many books are removed.
+  void remove(Catalog::Id id) {
+    if (auto it = bookToDoc.find(id); it != bookToDoc.end()) {
+      docAlive[it->second] = false;
+      bookToDoc.erase(it);
+    }
+  }
+
+  // books containing ALL the words of query
+  std::vector<Catalog::Id> search(std::string_view query) const {
+    std::vector<std::vector<uint32_t>> lists;
+    bool missing = false;
+    tokenize(query, [&](const std::string& w) {
+      auto it = words.find(w);
+      if (it == words.end()) missing = true;
+      else lists.push_back(it->second.decode());
+    });
+    std::vector<Catalog::Id> result;
+    if (missing || lists.empty()) return result;
+    // shortest lists first: the running result only gets smaller
+    std::sort(lists.begin(), lists.end(), [](auto& x, auto& y) { return x.size() < y.size(); });
+    std::vector<uint32_t> docs = std::move(lists[0]), next;
+    for (size_t i = 1; i < lists.size() && !docs.empty(); ++i) {
+      next.clear();
+      intersect(docs, lists[i], next);
+      docs.swap(next);
+    }
+    for (uint32_t d : docs) {
+      if (docAlive[d]) result.push_back(docToBook[d]);
+    }
+    return result;
+  }
+};
+// The dynamic_casts in add() run once per book when indexing, not per query.
+
+// client
+Catalog cat;
+TextIndex words;
+Catalog::Id id = cat.insert(std::make_unique<Comic>("The Dragon and the Moon", "A. Author", 40, "Moon Knight"));
+words.add(id, cat[id]);
+words.search("moon dragon"); // {id}
+cat.update(id, [](AbstractBook& b) { b.setTitle("Sunrise"); });
+words.add(id, cat[id]);      // re-index after a change
+words.search("dragon");      // {}
+
+
+// ********** Importing Many Books: Moves, Not Copies **********
+// Recall the Text ctor from 6.25:
+Text(string title, string author, int length, string topic) : 
+  Book{title, author, length}, topic{topic} { }
+// Importing with it, from strings we just read:
+string title, author, topic;
+/* read them */
+Text t{title, author, length, topic}; // copy 1: lvalues copied into the parameters
+                                      // copy 2: parameters copied into the fields
+// Each copy of a long string is a heap allocation plus copying the characters.
+// The classes above take the parameters by value and std::move them into the
+//   fields (copy 2 is gone). If the caller also passes temporaries, 
+//   copy 1 is gone too: the parameter is built directly from the temporary
+//   (elision, see 6.13), then moved. Each string is built once, from the file.
+
+// Bulk import: cut the file into shards by byte range (same rule as the
+//   roster in 5.14: a shard owns the lines that start in it), parse the 
+//   shards on several threads into batches of books, then hand the batches
+//   to the catalog in file order.
+// File format, one book per line, fields separated by tabs:
+//   B <title> <author> <length>
+//   T <title> <author> <length> <topic>
+//   C <title> <author> <length> <hero>
+import <charconv>;
+import <filesystem>;
+import <fstream>;
+import <thread>;
+
+using Batch = std::vector<std::unique_ptr<AbstractBook>>;
+
+// Parses the lines starting in [begin, end) of text into books.
+Batch parseBooks(std::string_view text, size_t begin, size_t end, size_t& badLines) {
+  Batch batch;
+  size_t p = begin;
+  if (p != 0) { // skip the line the previous shard owns
+    size_t nl = text.find('\n', p - 1);
+    p = nl == std::string_view::npos ? text.size() : nl + 1;
+  }
+  std::string_view f[5];
+  while (p < end && p < text.size()) {
+    size_t eol = std::min(text.find('\n', p), text.size());
+    std::string_view line = text.substr(p, eol - p);
+    p = eol + 1;
+    int n = 0;
+    for (size_t start = 0; n < 5; ++n) { // split on tabs, no copies (string_views)
+      size_t tab = line.find('\t', start);
+      f[n] = line.substr(start, tab == std::string_view::npos ? std::string_view::npos : tab - start);
+      if (tab == std::string_view::npos) { ++n; break; }
+      start = tab + 1;
+    }
+    int length = 0;
+    bool ok = n >= 4 && std::from_chars(f[3].data(), f[3].data() + f[3].size(), length).ec == std::errc{};
+    if (!ok) { if (!line.empty()) ++badLines; continue; }
+    // std::string{view} builds each string exactly once; it is a temporary,
+    //   so it moves into the parameter and then into the field
+    if (f[0] == "B") {
+      batch.push_back(std::make_unique<Book>(std::string{f[1]}, std::string{f[2]}, length));
+    } else if (f[0] == "T" && n == 5) {
+      batch.push_back(std::make_unique<Text>(std::string{f[1]}, std::string{f[2]}, length, std::string{f[4]}));
+    } else if (f[0] == "C" && n == 5) {
+      batch.push_back(std::make_unique<Comic>(std::string{f[1]}, std::string{f[2]}, length, std::string{f[4]}));
+    } else {
+      ++badLines;
+    }
+  }
+  return batch;
+}
+
+// Reads the file and parses it on several threads; one batch per shard, in file order.
+std::vector<Batch> parseFile(const std::string& path, unsigned threads, size_t& badLines) {
+  std::string text(std::filesystem::file_size(path), '\0');
+  std::ifstream{path, std::ios::binary}.read(text.data(), text.size()); // one read
+  threads = std::max(1u, threads);
+  size_t shard = text.size() / threads + 1;
+  std::vector<Batch> batches(threads);
+  std::vector<size_t> bad(threads, 0);
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; ++t) { // each thread only writes its own batch
+    workers.emplace_back([&, t] {
+      batches[t] = parseBooks(text, t * shard, std::min(text.size(), (t + 1) * shard), bad[t]);
+    });
+  }
+  for (auto& w : workers) w.join();
+  for (size_t b : bad) badLines += b;
+  return batches;
+}
+
+// Returns the number of books imported.
+size_t importBooks(const std::string& path, Catalog& cat, unsigned threads, size_t& badLines) {
+  size_t count = 0;
+  for (Batch& b : parseFile(path, threads, badLines)) {
+    count += b.size();
+    cat.insertBatch(std::move(b)); // moves the vector of pointers
+  }
+  return count;
+}
+// The Catalog is filled by one thread (this one) at the end: Catalog is not
+//   thread-safe, and inserting is cheap compared to parsing.
+
+// Benchmark: copies avoided (counted as heap allocations) and throughput.
+// Every string here is longer than 15 chars, so every string copy allocates.
+import <atomic>;
+import <chrono>;
+import <cstdlib>;
+import <iostream>;
+import <new>;
+import <random>;
+import <sstream>;
+std::atomic<size_t> allocations = 0;
+void* operator new(size_t n) { // count every allocation in the program
+  ++allocations;
+  if (void* p = std::malloc(n ? n : 1)) return p;
+  throw std::bad_alloc{};
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+int main() {
+  const int n = 1'000'000;
+  {
+    std::ofstream out{"books.tsv"};
+    std::mt19937 gen{246};
+    for (int i = 0; i < n; ++i) {
+      out << "BTC"[i % 3] << "\tThe Collected Volume " << i << "\tAuthor Number " << gen() % 50000 
+          << "\t" << gen() % 1000 << (i % 3 ? "\tAn Extra Long Topic Or Hero\n" : "\n");
+    }
+  }
+  using Clock = std::chrono::steady_clock;
+  auto secs = [](auto d) { return std::chrono::duration<double>(d).count(); };
+  double mb = std::filesystem::file_size("books.tsv") / 1e6;
+
+  // the old way: formatted reads into strings, passed as lvalues
+  Catalog old;
+  size_t a0 = allocations;
+  auto t0 = Clock::now();
+  {
+    std::ifstream in{"books.tsv"};
+    std::string line, type, title, author, len, extra;
+    while (std::getline(in, line)) {
+      std::istringstream ss{line};
+      std::getline(ss, type, '\t'); std::getline(ss, title, '\t');
+      std::getline(ss, author, '\t'); std::getline(ss, len, '\t'); std::getline(ss, extra);
+      int length = std::stoi(len);
+      if (type == "B") old.insert(std::make_unique<Book>(title, author, length));  // copies
+      else if (type == "T") old.insert(std::make_unique<Text>(title, author, length, extra));
+      else old.insert(std::make_unique<Comic>(title, author, length, extra));
+    }
+  }
+  double tOld = secs(Clock::now() - t0);
+  size_t oldAllocs = allocations - a0;
+
+  Catalog cat;
+  size_t bad = 0, imported = 0;
+  a0 = allocations;
+  t0 = Clock::now();
+  std::vector<Batch> batches = parseFile("books.tsv", std::thread::hardware_concurrency(), bad);
+  auto t1 = Clock::now();
+  for (Batch& b : batches) {
+    imported += b.size();
+    cat.insertBatch(std::move(b));
+  }
+  auto t2 = Clock::now();
+  double tNew = secs(t2 - t0);
+  size_t newAllocs = allocations - a0;
+
+  std::cout << "stream + copies: " << mb / tOld << " MB/s, " << double(oldAllocs) / n << " allocations per book\n"
+            << "bulk import:     " << mb / tNew << " MB/s, " << double(newAllocs) / imported << " allocations per book\n"
+            << "  parsing " << secs(t1 - t0) << "s on " << std::thread::hardware_concurrency() 
+            << " threads, inserting " << secs(t2 - t1) << "s\n"
+            << "avoided " << oldAllocs - newAllocs << " allocations (" << bad << " bad lines)" << std::endl;
+}
+// Both numbers include the allocations of the catalog itself (the book objects
+//   and the index nodes), which are the same in both runs; the difference
+//   is the string copies (plus the istringstream's copy of each line).
+// Each book still needs one allocation per long string: the fields must own
+//   their characters. What is gone is every allocation beyond that one.
+// Parsing scales with the threads; inserting into the indexes does not, and
+//   on large files it is most of the time (see the Catalog benchmark above).
+
+
+// ********** Sharing the Books between Threads: Snapshots **********
+// Report threads read the books while an updater thread assigns to them:
+std::mutex booksLock;
+std::vector<std::unique_ptr<AbstractBook>> books;
+// updater
+{ std::lock_guard lock{booksLock}; static_cast<Text&>(*books[i]) = newText; }
+// report
+{ std::lock_guard lock{booksLock}; for (auto& b : books) /* ... */; }
+// Without the lock a report could see half a Text assigned (a new title, an
+//   old topic). With it, every report waits for the updater and for the
+//   other reports, and a long report blocks the updater.
+
+// Instead: never change a book that a reader can see (copy-on-write).
+// -- A snapshot is an immutable version of the whole collection. Readers
+//    take the current one (one atomic load of a shared_ptr) and read it
+//    for as long as they like, with no lock. 
+// -- The writer copies what it changes, builds the next snapshot and 
+//    publishes it with one atomic store. Readers holding the old snapshot 
+//    are not disturbed; it is freed when the last of them lets go 
+//    (the shared_ptr reference count, see Shared Ownership above).
+// Copying the whole collection for every change would be too slow, so the
+//   snapshots share structure: books are kept in chunks of 256 pointers, and
+//   the next version copies only the chunks it changes. The rest, and all
+//   the unchanged books, are shared with the previous version.
+//
+//    version 1:  [chunk 0] [chunk 1] [chunk 2]
+//                    |         |         |
+//    version 2:  [chunk 0] [chunk 1'] [chunk 2]    chunk 1' = copy of chunk 1
+//                               |                    with one pointer replaced
+//                           new Text
+import <array>;
+import <atomic>;
+import <memory>;
+import <mutex>;
+import <unordered_map>;
+import <utility>;
+import <vector>;
+
+class BookSnapshot {
+  static constexpr size_t ChunkSize = 256;
+  using Chunk = std::array<std::shared_ptr<const AbstractBook>, ChunkSize>;
+  std::vector<std::shared_ptr<const Chunk>> chunks;
+  size_t n = 0;
+  friend class BookEdit;
+public:
+  size_t size() const { return n; }
+  const AbstractBook& operator[](size_t i) const { return *(*chunks[i / ChunkSize])[i % ChunkSize]; }
+  // the book itself, to keep it alive beyond this snapshot
+  std::shared_ptr<const AbstractBook> share(size_t i) const { return (*chunks[i / ChunkSize])[i % ChunkSize]; }
+  template <typename Fn> void forEach(Fn fn) const {
+    for (size_t i = 0; i < n; ++i) fn((*this)[i]);
+  }
+};
+
+// The changes for the next version. Copies a chunk the first time it is
+//   changed, and changes its copy in place after that.
+class BookEdit {
+  BookSnapshot& next;
+  std::unordered_map<size_t, BookSnapshot::Chunk*> copied; // chunks owned by this edit
+  BookSnapshot::Chunk& own(size_t c) {
+    auto it = copied.find(c);
+    if (it != copied.end()) return *it->second;
+    auto copy = std::make_shared<BookSnapshot::Chunk>(*next.chunks[c]);
+    copied[c] = copy.get();
+    next.chunks[c] = copy;
+    return *copy;
+  }
+public:
+  explicit BookEdit(BookSnapshot& next) : next{next} { }
+  size_t size() const { return next.size(); }
+  const AbstractBook& operator[](size_t i) const { return next[i]; }
+  void replace(size_t i, std::shared_ptr<const AbstractBook> b) {
+    own(i / BookSnapshot::ChunkSize)[i % BookSnapshot::ChunkSize] = std::move(b);
+  }
+  void push_back(std::shared_ptr<const AbstractBook> b) {
+    if (next.n % BookSnapshot::ChunkSize == 0) { // a new chunk belongs to this edit already
+      auto fresh = std::make_shared<BookSnapshot::Chunk>();
+      copied[next.chunks.size()] = fresh.get();
+      next.chunks.push_back(std::move(fresh));
+    }
+    own(next.n / BookSnapshot::ChunkSize)[next.n % BookSnapshot::ChunkSize] = std::move(b);
+    ++next.n;
+  }
+};
+
+class BookStore {
+  std::atomic<std::shared_ptr<const BookSnapshot>> current;
+  std::mutex writeLock; // one writer at a time; readers never take it
+public:
+  BookStore() : current{std::make_shared<const BookSnapshot>()} { }
+  // Readers: the latest published version. Never changes.
+  std::shared_ptr<const BookSnapshot> snapshot() const { return current.load(); }
+  // Writers: fn(BookEdit&) makes any number of changes; they are published
+  //   together, so readers see all of them or none.
+  template <typename Fn> void update(Fn fn) {
+    std::lock_guard lock{writeLock};
+    BookSnapshot next = *current.load(); // copies the chunk pointers only
+    BookEdit edit{next};
+    fn(edit);
+    current.store(std::make_shared<const BookSnapshot>(std::move(next)));
+  }
+};
+// A writer changes a book by building a new one: copy it, assign, replace.
+//   The assignment operators above still decide what may be assigned to what.
+store.update([&](BookEdit& e) {
+  auto t = std::make_shared<Text>(dynamic_cast<const Text&>(e[i])); // copy
+  *t = newText;                                                      // Text::operator=
+  e.replace(i, std::move(t));
+});
+// A report:
+auto snap = store.snapshot(); // the version at this moment, for the whole report
+snap->forEach([](const AbstractBook& b) { /* ... */ });
+
+// Costs:
+// -- a reader pays one atomic load and a reference count increment per 
+//    snapshot, not per book. (std::atomic<std::shared_ptr> in libstdc++ 
+//    uses a tiny internal lock for the load; it is held for a few 
+//    instructions, never while anybody reads books.)
+// -- an update copies n/256 chunk pointers plus one chunk per changed chunk.
+//    Batch many changes into one update() to pay that once.
+// -- memory: old versions live until their last reader is done.
+
+// Benchmark: readers summing random books while one writer updates a book
+//   about once a millisecond, with the single lock vs. snapshots.
+import <chrono>;
+import <iostream>;
+import <random>;
+import <thread>;
+int main(int argc, char* argv[]) {
+  const int n = 1'000'000, perReport = 1000;
+  const int readers = argc > 1 ? std::stoi(argv[1]) : 4;
+  const auto runFor = std::chrono::seconds{2};
+  auto makeText = [](int i) { return Text{"Title " + std::to_string(i), "Author", i % 1000, "Topic"}; };
+
+  std::mutex lockedLock;
+  std::vector<std::unique_ptr<AbstractBook>> locked;
+  BookStore store;
+  store.update([&](BookEdit& e) {
+    for (int i = 0; i < n; ++i) {
+      locked.push_back(std::make_unique<Text>(makeText(i)));
+      e.push_back(std::make_shared<Text>(makeText(i)));
+    }
+  });
+
+  auto run = [&](const char* name, auto report, auto write) {
+    std::atomic<bool> done = false;
+    std::atomic<long> reports = 0, writes = 0;
+    std::vector<std::thread> ts;
+    for (int r = 0; r < readers; ++r) {
+      ts.emplace_back([&, r] {
+        std::mt19937 gen(r);
+        long sum = 0;
+        while (!done) { sum += report(gen); ++reports; }
+        if (sum == 42) std::cout << ""; // keep sum alive
+      });
+    }
+    ts.emplace_back([&] {
+      std::mt19937 gen(99);
+      for (int k = 0; !done; ++k) { write(gen, k); ++writes; std::this_thread::sleep_for(std::chrono::milliseconds{1}); }
+    });
+    std::this_thread::sleep_for(runFor);
+    done = true;
+    for (auto& t : ts) t.join();
+    double s = std::chrono::duration<double>(runFor).count();
+    std::cout << name << ": " << reports / s << " reports/s, " << writes / s << " updates/s" << std::endl;
+  };
+
+  run("single lock", [&](std::mt19937& gen) {
+    std::lock_guard lock{lockedLock};
+    long sum = 0;
+    for (int j = 0; j < perReport; ++j) sum += locked[gen() % n]->getLength();
+    return sum;
+  }, [&](std::mt19937& gen, int k) {
+    std::lock_guard lock{lockedLock};
+    static_cast<Text&>(*locked[gen() % n]) = makeText(k);
+  });
+  run("snapshots  ", [&](std::mt19937& gen) {
+    auto snap = store.snapshot();
+    long sum = 0;
+    for (int j = 0; j < perReport; ++j) sum += (*snap)[gen() % n].getLength();
+    return sum;
+  }, [&](std::mt19937& gen, int k) {
+    store.update([&](BookEdit& e) {
+      size_t i = gen() % n;
+      auto t = std::make_shared<Text>(dynamic_cast<const Text&>(e[i]));
+      *t = makeText(k);
+      e.replace(i, std::move(t));
+    });
+  });
+}
+// On a single core the readers take turns anyway, so the lock costs little,
+//   and the snapshot pays for its extra level of pointers (a chunk, then
+//   the book). The lock's cost is in waiting: with several readers on
+//   several cores they serialize on it, and a report holds up the updater
+//   for its whole length. Snapshot readers never wait for anybody.
+// An update here costs about 4000 pointer copies (10^6 / 256): fine for 
+//   occasional updates. For frequent ones, batch them, or add a level of
+//   chunks (a tree of chunks: each update copies one path, log(n) chunks).
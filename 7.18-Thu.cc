@@ -132,6 +132,108 @@ struct Student {
 };
 int Student::numInstances = 0;
 
+// Problems with numInstances as a census of Students:
+// -- only the one ctor increments it: copies and moves are not counted
+// -- nothing decrements it, so it counts "ever created", not "alive now"
+// -- ++numInstances from two threads at once is a data race
+// -- every class that wants this has to write it all again
+
+// A reusable version: a class template that a class inherits from 
+//   to opt in. It counts, per type T:
+//   constructed (any ctor), copied, moved, copy/move assigned, destroyed,
+//   and the live and peak number of objects.
+// The counters are CallCounters (see 6.18): each thread counts in its own
+//   cache line with relaxed atomics, so counting is cheap and thread-safe.
+// Only the live count is one shared atomic, because the peak needs to
+//   compare against an exact current value.
+import <atomic>;
+import <iostream>;
+import <string>;
+import <typeinfo>;
+import <vector>;
+
+struct CensusCounts {
+  long long constructed, copied, moved, copyAssigned, moveAssigned, destroyed;
+  long long live, peak;
+};
+
+// Every type that opts in adds itself here, so we can list them all at run time
+struct CensusEntry {
+  std::string name;
+  CensusCounts (*counts)(); // function returning that type's counts
+};
+inline std::vector<CensusEntry>& censusRegistry() {
+  static std::vector<CensusEntry> types;
+  return types;
+}
+
+template <typename T> class Census {
+  inline static CallCounter constructed, copied, moved, copyAssigned, moveAssigned, destroyed;
+  inline static std::atomic<long long> live = 0, peak = 0;
+  // initialized once, before main, for each T that uses Census<T>
+  inline static const bool registered = 
+    (censusRegistry().push_back({typeid(T).name(), &Census::counts}), true);
+
+  static void born() {
+    constructed.increment();
+    long long now = live.fetch_add(1, std::memory_order_relaxed) + 1;
+    long long p = peak.load(std::memory_order_relaxed);
+    while (now > p && !peak.compare_exchange_weak(p, now, std::memory_order_relaxed)) { }
+    // only loops when we are setting a new peak
+  }
+
+protected: // only T (the subclass) creates and destroys Census<T> parts
+  Census() { (void)registered; born(); }
+  Census(const Census&) { born(); copied.increment(); }
+  Census(Census&&) noexcept { born(); moved.increment(); }
+  Census& operator=(const Census&) { copyAssigned.increment(); return *this; }
+  Census& operator=(Census&&) noexcept { moveAssigned.increment(); return *this; }
+  ~Census() { // not virtual: nobody deletes through a Census<T>*
+    destroyed.increment();
+    live.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+public:
+  static CensusCounts counts() {
+    return {constructed.value(), copied.value(), moved.value(), 
+            copyAssigned.value(), moveAssigned.value(), destroyed.value(),
+            live.load(std::memory_order_relaxed), peak.load(std::memory_order_relaxed)};
+  }
+};
+
+// Opting in: inherit from Census<YourClass> (the class passes itself as T, 
+//   so each class gets its own set of static counters)
+struct Student : Census<Student> {
+  int assns, mt, final;
+  Student(int a, int m, int f) : assns{a}, mt{m}, final{f} { }
+  // the compiler-provided copy/move ctors call Census's copy/move ctors
+};
+
+void printCensus() {
+  for (auto& [name, counts] : censusRegistry()) {
+    CensusCounts c = counts();
+    std::cout << name << ": live " << c.live << ", peak " << c.peak 
+              << ", constructed " << c.constructed << " (copies " << c.copied 
+              << ", moves " << c.moved << "), assigned " << c.copyAssigned 
+              << " + " << c.moveAssigned << " moved, destroyed " << c.destroyed << '\n';
+  }
+}
+
+int main() {
+  {
+    std::vector<Student> v;
+    for (int i = 0; i < 3; ++i) {
+      v.push_back(Student{60, 70, 80}); // a move into v, plus moves when v grows
+    }
+    Student copy = v[0]; // a copy
+  }
+  printCensus(); // live 0: nothing leaked; moves show the vector regrowing
+}
+// Reading the numbers:
+// -- a leak shows up as live that keeps growing and never comes back down
+// -- a copy storm shows up as copied being much larger than 
+//    constructed - copied - moved (the objects we actually meant to create)
+
 
 
 // ********** Factory Method Pattern **********
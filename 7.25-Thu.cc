@@ -179,3 +179,133 @@ OutIter copy(InIter first, InIter last, OutIter result) {
 vector v{1, 2, 3, 4, 5, 6, 7};
 vector<int> w(4); // Creating a vector of 4 elements
 copy(v.begin() + 1, v.begin() + 5, w.begin()); // w = {2, 3, 4, 5}
+
+
+
+// ********** Algorithms at Work: Top-k and Percentiles **********
+// "Who are the top 100 students?" and "what grade is the 90th percentile?"
+// Easy way: sort everyone by grade and look at the front / the right position.
+sort(roster.begin(), roster.end(), 
+     [](const Student& a, const Student& b) { return a.grade() > b.grade(); });
+// That's O(n log n), and grade() is recomputed in every comparison 
+//   (about 2 n log n calls). We don't need everything in order.
+
+import <algorithm>;
+import <cmath>;
+import <functional>;
+import <queue>;
+import <utility>;
+import <vector>;
+
+// Top k with a bounded heap: keep the k best seen so far in a min-heap, 
+//   so the worst of the k best is on top and easy to replace.
+//   O(n log k), and grade() runs once per student.
+std::vector<size_t> topK(const std::vector<Student>& roster, size_t k) {
+  using Entry = std::pair<float, size_t>; // (grade, index in roster)
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> best; // min-heap
+  for (size_t i = 0; i < roster.size(); ++i) {
+    float g = roster[i].grade();
+    if (best.size() < k) best.push({g, i});
+    else if (k > 0 && g > best.top().first) { best.pop(); best.push({g, i}); }
+  }
+  std::vector<size_t> result(best.size());
+  for (size_t i = result.size(); i > 0; --i) { // heap gives worst first
+    result[i - 1] = best.top().second;
+    best.pop();
+  }
+  return result; // indexes, best student first
+}
+
+// Percentile with nth_element: rearranges so that the element at position m
+//   is the one that would be there if we sorted, with smaller ones before it
+//   and larger ones after it (in no particular order). O(n) on average.
+// p in [0, 100] (clamped); nearest-rank definition.
+// p * n / 100 rather than p / 100 * n: for whole p and n it is exact, so ceil
+//   does not round 4500000.0000001 up to the next rank.
+size_t nearestRank(double p, size_t n) { // 1..n
+  p = std::clamp(p, 0.0, 100.0);
+  return std::max<size_t>(static_cast<size_t>(std::ceil(p * n / 100)), 1);
+}
+
+float percentile(const std::vector<Student>& roster, double p) {
+  if (roster.empty()) return 0;
+  std::vector<float> grades;
+  grades.reserve(roster.size());
+  for (const Student& s : roster) grades.push_back(s.grade()); // grade() once each
+  size_t m = nearestRank(p, grades.size()) - 1;
+  std::nth_element(grades.begin(), grades.begin() + m, grades.end());
+  return grades[m];
+}
+
+// Asking many questions about the same roster? Then sorting once pays off.
+// The index sorts (grade, index) pairs, not Students: small, and grade()
+//   is computed once per student instead of in every comparison.
+class GradeIndex {
+  std::vector<std::pair<float, size_t>> sorted; // ascending by grade
+
+public:
+  explicit GradeIndex(const std::vector<Student>& roster) {
+    sorted.reserve(roster.size());
+    for (size_t i = 0; i < roster.size(); ++i) sorted.push_back({roster[i].grade(), i});
+    std::sort(sorted.begin(), sorted.end());
+  }
+  std::vector<size_t> topK(size_t k) const { // O(k)
+    std::vector<size_t> result;
+    for (auto it = sorted.rbegin(); it != sorted.rend() && result.size() < k; ++it) {
+      result.push_back(it->second);
+    }
+    return result;
+  }
+  float percentile(double p) const { // O(1)
+    if (sorted.empty()) return 0;
+    return sorted[nearestRank(p, sorted.size()) - 1].first;
+  }
+};
+// The index holds positions in the roster, so rebuild it if the roster changes.
+
+// Benchmark
+import <chrono>;
+import <iostream>;
+import <random>;
+int main() {
+  std::mt19937 gen{246};
+  std::uniform_int_distribution<int> mark{0, 100};
+  std::vector<Student> roster;
+  for (int i = 0; i < 5'000'000; ++i) roster.push_back(Student{mark(gen), mark(gen), mark(gen)});
+
+  using Clock = std::chrono::steady_clock;
+  auto ms = [](auto d) { return std::chrono::duration<double, std::milli>(d).count(); };
+
+  auto t0 = Clock::now();
+  std::vector<Student> sorted = roster;
+  std::sort(sorted.begin(), sorted.end(), 
+            [](const Student& a, const Student& b) { return a.grade() > b.grade(); });
+  float sortTop = sorted[99].grade();
+  float sortP90 = sorted[sorted.size() - nearestRank(90, sorted.size())].grade();
+  double tSort = ms(Clock::now() - t0);
+
+  t0 = Clock::now();
+  std::vector<size_t> top = topK(roster, 100);
+  double tHeap = ms(Clock::now() - t0);
+
+  t0 = Clock::now();
+  float p90 = percentile(roster, 90);
+  double tNth = ms(Clock::now() - t0);
+
+  t0 = Clock::now();
+  GradeIndex index{roster};
+  double tBuild = ms(Clock::now() - t0);
+  t0 = Clock::now();
+  for (int q = 1; q <= 99; ++q) index.percentile(q);
+  std::vector<size_t> top2 = index.topK(100);
+  double tQueries = ms(Clock::now() - t0);
+
+  std::cout << "sort everything:  " << tSort << "ms\n"
+            << "top 100 by heap:  " << tHeap << "ms\n"
+            << "p90 nth_element:  " << tNth << "ms\n"
+            << "GradeIndex build: " << tBuild << "ms, then 100 queries " << tQueries << "ms\n"
+            // same answers (ties may list different students with the same grade)
+            << (roster[top.back()].grade() == sortTop && p90 == sortP90 
+                && index.percentile(90) == p90 && roster[top2.back()].grade() == sortTop 
+                ? "same answers" : "DIFFERENT") << std::endl;
+}
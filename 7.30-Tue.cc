@@ -221,3 +221,158 @@ public:
     return *this;
   }
 };
+
+
+
+// ********** Cheaper Type Checks: Type Tags **********
+// dynamic_cast has to walk the run time type information (RTTI) at run time 
+//   to find out whether the object really is a Text. whatIsIt() may do that 
+//   twice, and Text::operator= does it on every single assignment.
+// If the hierarchy is closed (we know all the classes: Book, Text, Comic, 
+//   and nobody else derives from them), each object can simply carry a
+//   small tag saying what it is. Checking the tag is one compare.
+import <cstdint>;
+import <string>;
+import <typeinfo>;
+
+enum class BookKind : uint8_t { Book, Text, Comic };
+
+class Book {
+  BookKind k;
+  std::string title, author;
+  int length;
+protected:
+  // subclasses pass their own kind up
+  Book(BookKind k, std::string title, std::string author, int length) :
+    k{k}, title{std::move(title)}, author{std::move(author)}, length{length} { }
+  Book(const Book& other, BookKind k) : 
+    k{k}, title{other.title}, author{other.author}, length{other.length} { }
+public:
+  static constexpr BookKind Kind = BookKind::Book;
+  Book(std::string title, std::string author, int length) :
+    Book{BookKind::Book, std::move(title), std::move(author), length} { }
+  // Copying a Book out of a Text (slicing: Book b = t;) makes a plain Book,
+  //   so the tag must be reset; the default copy ctor would copy "Text".
+  Book(const Book& other) : Book{other, BookKind::Book} { }
+  virtual ~Book() = default;
+  BookKind kind() const { return k; } // not virtual: just reads the field
+  virtual std::string identify() const { return "Normal Book"; }
+  virtual Book& operator=(const Book& other);
+};
+
+// final: closes the hierarchy. A subclass of Text would need a tag of its own,
+//   and book_cast<Text> would not recognize it (dynamic_cast would).
+class Text final : public Book {
+  std::string topic;
+public:
+  static constexpr BookKind Kind = BookKind::Text;
+  Text(std::string title, std::string author, int length, std::string topic) :
+    Book{Kind, std::move(title), std::move(author), length}, topic{std::move(topic)} { }
+  Text(const Text& other) : Book{other, Kind}, topic{other.topic} { } // keeps the tag
+  Text& operator=(const Text& other) = default;
+  std::string identify() const override { return "Text"; }
+  const std::string& getTopic() const { return topic; }
+  Text& operator=(const Book& other) override;
+};
+
+class Comic final : public Book {
+  std::string hero;
+public:
+  static constexpr BookKind Kind = BookKind::Comic;
+  Comic(std::string title, std::string author, int length, std::string hero) :
+    Book{Kind, std::move(title), std::move(author), length}, hero{std::move(hero)} { }
+  Comic(const Comic& other) : Book{other, Kind}, hero{other.hero} { }
+  Comic& operator=(const Comic& other) = default;
+  std::string identify() const override { return "Comic"; }
+  Comic& operator=(const Book& other) override;
+};
+
+// book_cast: like dynamic_cast, but checks the tag.
+// Pointer version: nullptr if b is not exactly a T
+template <typename T> T* book_cast(Book* b) {
+  return b && b->kind() == T::Kind ? static_cast<T*>(b) : nullptr;
+}
+template <typename T> const T* book_cast(const Book* b) {
+  return b && b->kind() == T::Kind ? static_cast<const T*>(b) : nullptr;
+}
+// Reference version: throws std::bad_cast, same as dynamic_cast<T&>
+template <typename T> const T& book_cast(const Book& b) {
+  if (b.kind() != T::Kind) throw std::bad_cast{};
+  return static_cast<const T&>(b);
+}
+
+// whatIsIt with one compare, no RTTI:
+void whatIsIt(Book* b) {
+  using std::cout;
+  if (!b) { cout << "Nothing"; return; }
+  switch (b->kind()) {
+    case BookKind::Text:  cout << "Text"; break;
+    case BookKind::Comic: cout << "Comic"; break;
+    case BookKind::Book:  cout << "Normal Book"; break;
+  }
+}
+// Unlike the if/else chain, with a switch on an enum the compiler warns 
+//   (-Wall) if a case is missing when a new kind is added.
+
+// The polymorphic assignment from before, without dynamic_cast:
+Book& Book::operator=(const Book& other) {
+  if (other.kind() != kind()) throw std::bad_cast{}; // no mixed assignment
+  title = other.title;
+  author = other.author;
+  length = other.length;
+  return *this;
+}
+Text& Text::operator=(const Book& other) {
+  const Text& textother = book_cast<Text>(other); // throws if not a Text
+  Book::operator=(other);
+  topic = textother.topic;
+  return *this;
+}
+Comic& Comic::operator=(const Book& other) { // needed too: Book's would skip hero
+  const Comic& comicother = book_cast<Comic>(other);
+  Book::operator=(other);
+  hero = comicother.hero;
+  return *this;
+}
+
+// Benchmark: count the Texts in a shuffled array of Book*, three ways
+import <algorithm>;
+import <chrono>;
+import <iostream>;
+import <memory>;
+import <random>;
+import <vector>;
+int main() {
+  std::mt19937 gen{246};
+  std::vector<std::unique_ptr<Book>> owned;
+  for (int i = 0; i < 3'000'000; ++i) {
+    switch (gen() % 3) {
+      case 0: owned.push_back(std::make_unique<Book>("b", "a", 100)); break;
+      case 1: owned.push_back(std::make_unique<Text>("t", "a", 100, "CS")); break;
+      case 2: owned.push_back(std::make_unique<Comic>("c", "a", 100, "X")); break;
+    }
+  }
+  std::vector<Book*> books;
+  for (auto& p : owned) books.push_back(p.get());
+  std::shuffle(books.begin(), books.end(), gen);
+
+  using Clock = std::chrono::steady_clock;
+  auto ms = [](auto d) { return std::chrono::duration<double, std::milli>(d).count(); };
+  int a = 0, b = 0, c = 0;
+  auto t0 = Clock::now();
+  for (Book* p : books) {
+    if (dynamic_cast<Text*>(p)) ++a;
+    else if (dynamic_cast<Comic*>(p)) { } // whatIsIt's chain
+  }
+  double tDynamic = ms(Clock::now() - t0);
+  t0 = Clock::now();
+  for (Book* p : books) b += p->identify() == "Text";
+  double tVirtual = ms(Clock::now() - t0);
+  t0 = Clock::now();
+  for (Book* p : books) c += book_cast<Text>(p) != nullptr;
+  double tTag = ms(Clock::now() - t0);
+  std::cout << "dynamic_cast: " << tDynamic << "ms, identify(): " << tVirtual 
+            << "ms, kind(): " << tTag << "ms, " << (a == b && b == c ? "same" : "DIFFERENT") << std::endl;
+}
+// identify() is slow here mostly because it builds and compares a std::string;
+//   it is still the right tool when we want the behaviour, not the type.